@@ -2,7 +2,7 @@
   ANAVI Word Clock
   8x8 WS2812B LEDs using XIAO ESP32C3
 
-  grid pattern
+  grid pattern (faceplate.h)
 
   A T W E N T Y D
   Q U A R T E R Y
@@ -26,6 +26,8 @@
 // Include function headers
 #include "clock.h"
 #include "network.h"
+#include "scheduler.h"
+#include "perf.h"
 
 // include the library code:
 #include <Wire.h>
@@ -34,6 +36,11 @@
 #include <Adafruit_NeoPixel.h>
 #include <RTClib.h>
 
+#ifdef RTOS_TASKS
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#endif
+
 DateTime theTime; // Holds current clock time
 
 // Create WordClock instance
@@ -42,6 +49,237 @@ WordClock wordClock;
 // Create NetworkConnector instance
 NetworkConnector networkConnector;
 
+// Cooperative scheduler driving loop()
+TaskScheduler scheduler;
+
+// Debounced button state, sampled by the input tick
+bool buttonPressed = false;
+
+// The renderer's copy of the network state, kept by display commands
+bool lightOn = true;
+uint32_t lightColor = 0;
+uint8_t displayLink = 0;
+uint32_t localEpoch = 0;           // local time at localEpochAt
+unsigned long localEpochAt = 0;    // micros()
+
+// Last report sent to the network side, and boot to the first time frame
+DisplayReport displayReport = {};
+unsigned long displayReportedAt = 0;
+unsigned long firstFrameMs = 0;
+
+// MQTT light commands, from the callback to the renderer
+JitterStats commandLatency;
+
+void applyDisplayCommands()
+{
+    DisplayCommand command;
+    while (networkConnector.nextDisplayCommand(command))
+    {
+        switch (command.type)
+        {
+            case DisplayCommand::POWER:
+                lightOn = command.value;
+                commandLatency.record(micros() - command.queuedUs);
+                break;
+            case DisplayCommand::COLOR:
+                lightColor = command.value;
+                commandLatency.record(micros() - command.queuedUs);
+                break;
+            case DisplayCommand::TIME:
+                localEpoch = command.value;
+                localEpochAt = command.queuedUs;
+                break;
+            case DisplayCommand::LINK:
+                displayLink = command.value;
+                break;
+            case DisplayCommand::STOP_INTRO:
+                wordClock.stopIntro();
+                break;
+        }
+    }
+}
+
+void reportDisplay()
+{
+    const WordClock::Mask& words = wordClock.getWordMask();
+    bool changed = wordClock.getBrightness() != displayReport.brightness ||
+                   firstFrameMs != displayReport.firstFrameMs;
+    for (uint8_t w = 0; w < WordClock::Mask::WORDS; w++)
+    {
+        changed = changed || words.data()[w] != displayReport.wordMask[w];
+    }
+    if (!changed && millis() - displayReportedAt < DISPLAY_REPORT_MS)
+    {
+        return;
+    }
+    DisplayReport report = {};
+    for (uint8_t w = 0; w < WordClock::Mask::WORDS; w++)
+    {
+        report.wordMask[w] = words.data()[w];
+    }
+    report.words = WordClock::Mask::WORDS;
+    report.brightness = wordClock.getBrightness();
+    report.averageMa = wordClock.getAverageMa();
+    report.peakMa = wordClock.getPeakMa();
+    report.firstFrameMs = firstFrameMs;
+    // A full queue gets the report again on the next tick
+    if (networkConnector.postDisplayReport(report))
+    {
+        displayReport = report;
+        displayReportedAt = millis();
+    }
+}
+
+void renderTick()
+{
+    applyDisplayCommands();
+    if (wordClock.serviceIntro())
+    {
+        return;
+    }
+    if (!(displayLink & DISPLAY_LINK_TIME))
+    {
+        // Nothing to show yet, say what the clock is waiting for
+        if (displayLink & DISPLAY_LINK_WIFI)
+        {
+            wordClock.showStatusHomeAssistant();
+        }
+        else
+        {
+            wordClock.showStatusWiFi();
+        }
+        return;
+    }
+    // Counts on from the last second the network side sent, so the
+    // display keeps time through a slow network pass
+    theTime = DateTime(localEpoch + (micros() - localEpochAt) / 1000000);
+
+    wordClock.setPower(lightOn);
+    wordClock.setColor(lightColor);
+    wordClock.adjustBrightness(theTime);
+    wordClock.displayTime(theTime);
+
+    if (!firstFrameMs && wordClock.getFirstFrameMicros())
+    {
+        // micros() starts at reset, so this is boot to the first time frame
+        firstFrameMs = wordClock.getFirstFrameMicros() / 1000;
+        Serial.print("First time frame ");
+        Serial.print(firstFrameMs);
+        Serial.println(" ms after boot");
+    }
+    reportDisplay();
+}
+
+void ledTick()
+{
+    wordClock.serviceOutput();
+}
+
+void ntpTick()
+{
+    networkConnector.updateTime();
+}
+
+void mqttTick()
+{
+    networkConnector.loop();
+}
+
+#ifdef PERF_PROBES
+void perfTick()
+{
+    perfSnapshot();
+    perfDump(Serial);
+    networkConnector.publishPerf();
+}
+#endif
+
+void inputTick()
+{
+    // Sampling slower than the contact bounce is enough to debounce it
+    const bool pressed = (LOW == digitalRead(pinButton));
+    if (pressed != buttonPressed)
+    {
+        buttonPressed = pressed;
+        if (pressed)
+        {
+            Serial.println("Button pressed");
+            networkConnector.postDisplayCommand(DisplayCommand::STOP_INTRO, 0);
+        }
+    }
+    networkConnector.serviceFactoryReset(buttonPressed);
+}
+
+#ifdef RTOS_TASKS
+// Network side ticks, run by the network task
+TaskScheduler networkScheduler;
+
+TaskHandle_t renderTaskHandle = nullptr;
+TaskHandle_t networkTaskHandle = nullptr;
+bool tasksRunning = false;
+
+// Wake-ups of each task against its period
+JitterStats renderJitter;
+JitterStats networkJitter;
+
+void renderTask(void* parameters)
+{
+    TickType_t wakeAt = xTaskGetTickCount();
+    unsigned long wokeAt = micros();
+    for (;;)
+    {
+        vTaskDelayUntil(&wakeAt, pdMS_TO_TICKS(RENDER_TICK_MS));
+        const unsigned long now = micros();
+        renderJitter.recordInterval(now - wokeAt, RENDER_TICK_MS * 1000UL);
+        wokeAt = now;
+        renderTick();
+        ledTick();
+        if (xTaskGetTickCount() - wakeAt >= pdMS_TO_TICKS(RENDER_TICK_MS))
+        {
+            // A period or more behind: skip the missed ticks instead of
+            // bursting through them
+            wakeAt = xTaskGetTickCount();
+        }
+    }
+}
+
+void networkTask(void* parameters)
+{
+    unsigned long passAt = micros();
+    for (;;)
+    {
+        // Always gives up the CPU, a long pass is not made up for
+        vTaskDelay(pdMS_TO_TICKS(NETWORK_TICK_MS));
+        const unsigned long now = micros();
+        networkJitter.recordInterval(now - passAt, NETWORK_TICK_MS * 1000UL);
+        passAt = now;
+        networkScheduler.run();
+    }
+}
+
+bool startTasks()
+{
+    networkScheduler.addTask(ntpTick, NTP_TICK_MS);
+    networkScheduler.addTask(mqttTick, MQTT_TICK_MS);
+    networkScheduler.addTask(inputTick, INPUT_TICK_MS);
+    #ifdef PERF_PROBES
+    networkScheduler.addTask(perfTick, PERF_REPORT_MS);
+    #endif
+    if (pdPASS != xTaskCreatePinnedToCore(networkTask, "network", NETWORK_TASK_STACK, nullptr,
+                                          NETWORK_TASK_PRIORITY, &networkTaskHandle, TASK_CORE))
+    {
+        return false;
+    }
+    if (pdPASS != xTaskCreatePinnedToCore(renderTask, "render", RENDER_TASK_STACK, nullptr,
+                                          RENDER_TASK_PRIORITY, &renderTaskHandle, TASK_CORE))
+    {
+        vTaskDelete(networkTaskHandle);
+        return false;
+    }
+    return true;
+}
+#endif
+
 void setup()
 {
     // Set pinmodes
@@ -57,39 +295,51 @@ void setup()
     // Initialize the word clock
     wordClock.begin();
 
-    // Startup animations
-    wordClock.rainbowCycle(5);
-    delay(100);
-    wordClock.flashWords();
-    delay(100);
-
-    // Initialize network manager (includes factory reset check, config loading, machine ID)
+    // Config comes from one NVS read, and a time cached before a reset
+    // is available right away
     networkConnector.begin();
 
-    // Show WiFi status
-    wordClock.showStatusWiFi();
+    #ifdef BOOT_ANIMATION
+    wordClock.startIntro();
+    #endif
 
-    // Setup WiFi connection
+    // Neither blocks: WiFi, NTP and MQTT come up from the network ticks while
+    // the clock already shows the time
     networkConnector.setupWiFi();
-
-    // Show Home Assistant status
-    wordClock.showStatusHomeAssistant();
-
-    // Setup MQTT
     networkConnector.setupMQTT();
 
     // Print configuration summary
     networkConnector.printConfiguration();
+
+    #ifdef RTOS_TASKS
+    tasksRunning = startTasks();
+    if (tasksRunning)
+    {
+        Serial.println("Render and network tasks started");
+        return;
+    }
+    Serial.println("Task start failed, running from loop()");
+    #endif
+
+    // Steady-state work, nothing in these ticks may block
+    scheduler.addTask(renderTick, RENDER_TICK_MS);
+    scheduler.addTask(ledTick, LED_TICK_MS);
+    scheduler.addTask(ntpTick, NTP_TICK_MS);
+    scheduler.addTask(mqttTick, MQTT_TICK_MS);
+    scheduler.addTask(inputTick, INPUT_TICK_MS);
+    #ifdef PERF_PROBES
+    scheduler.addTask(perfTick, PERF_REPORT_MS);
+    #endif
 }
 
 void loop()
 {
-    networkConnector.updateTime();
-  
-    unsigned long epochTime = networkConnector.getEpochTime();
-    theTime = DateTime(epochTime);
-
-    wordClock.adjustBrightness(theTime);
-    wordClock.displayTime(theTime);
-    delay(5);
+    #ifdef RTOS_TASKS
+    if (tasksRunning)
+    {
+        // Everything runs in the two tasks, hand back the loopTask stack
+        vTaskDelete(nullptr);
+    }
+    #endif
+    scheduler.run();
 }
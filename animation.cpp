@@ -0,0 +1,54 @@
+/*
+  ANAVI Word Clock - Animation Clock Implementation
+  Fixed-timestep animation phase derived from a monotonic microsecond clock
+*/
+
+#include "animation.h"
+
+AnimationClock::AnimationClock(uint32_t frameUs, uint16_t period)
+    : frameUs(frameUs)
+    , period(period)
+    , phase(0)
+    , elapsedUs(0)
+    , lastNowUs(0)
+    , started(false)
+    , step(0)
+    , framesDropped(0)
+    , framesThisWindow(0)
+    , windowStartUs(0)
+    , fps(0)
+{
+}
+
+bool AnimationClock::update(unsigned long nowUs)
+{
+    if (!started)
+    {
+        started = true;
+        lastNowUs = nowUs;
+        return true;
+    }
+
+    // Unsigned difference stays correct across the micros() wrap
+    elapsedUs += (unsigned long)(nowUs - lastNowUs);
+    lastNowUs = nowUs;
+
+    if (elapsedUs - windowStartUs >= 1000000)
+    {
+        fps = framesThisWindow * 1000000.0f / (float)(elapsedUs - windowStartUs);
+        framesThisWindow = 0;
+        windowStartUs = elapsedUs;
+    }
+
+    const uint64_t currentStep = elapsedUs / frameUs;
+    if (currentStep == step)
+    {
+        return false;
+    }
+    framesDropped += (uint32_t)(currentStep - step - 1);
+    const uint16_t advance = (uint16_t)((currentStep - step) % period);
+    phase = (phase + advance) % period;
+    step = currentStep;
+    framesThisWindow++;
+    return true;
+}
@@ -0,0 +1,45 @@
+/*
+  ANAVI Word Clock - Animation Clock Header
+  Fixed-timestep animation phase derived from a monotonic microsecond clock
+*/
+
+#ifndef ANIMATION_CLOCK_H
+#define ANIMATION_CLOCK_H
+
+#include <Arduino.h>
+
+class AnimationClock {
+public:
+    // Constructor, frameUs is the time budget of one animation step and
+    // period the number of steps before the phase wraps
+    AnimationClock(uint32_t frameUs, uint16_t period);
+
+    // Advance to the current time. Returns true when the phase moved to a
+    // new step; steps that were missed are dropped, not replayed.
+    bool update(unsigned long nowUs);
+
+    uint16_t getPhase() const { return phase; }
+
+    // Frames rendered per second over the last full second
+    float getFps() const { return fps; }
+    uint32_t getFrameBudgetUs() const { return frameUs; }
+    uint32_t getFramesDropped() const { return framesDropped; }
+
+private:
+    uint32_t frameUs;
+    uint16_t period;
+    uint16_t phase;
+
+    // 64-bit elapsed time, immune to the 71 minute micros() wrap
+    uint64_t elapsedUs;
+    unsigned long lastNowUs;
+    bool started;
+    uint64_t step;
+
+    uint32_t framesDropped;
+    uint16_t framesThisWindow;
+    uint64_t windowStartUs;
+    float fps;
+};
+
+#endif // ANIMATION_CLOCK_H
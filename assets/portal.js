@@ -0,0 +1,40 @@
+// ANAVI Word Clock - configuration portal script
+// Served gzip'd from flash as /portal.js, see tools/embed_assets.py
+document.addEventListener("DOMContentLoaded", function () {
+  var machineId = document.getElementById("mid");
+  if (machineId) {
+    fetch("/portal/id").then(function (r) { return r.text(); })
+      .then(function (text) { machineId.textContent = text; });
+  }
+
+  var tzSelect = document.getElementById("tz");
+  var tzField = document.getElementById("timezone");
+  if (!tzSelect || !tzField) return;
+  tzSelect.addEventListener("change", function () { tzField.value = tzSelect.value; });
+
+  // The options are streamed by the clock, the saved zone comes selected
+  fetch("/portal/tz").then(function (r) { return r.text(); }).then(function (html) {
+    tzSelect.innerHTML = html;
+    // A rule outside the list, such as one set over MQTT, is kept;
+    // anything else follows the browser
+    var current = tzSelect.options[tzSelect.selectedIndex];
+    if (current && current.getAttribute("data-rule") !== null) return;
+
+    // The browser's offsets in January and July, in seconds east of UTC.
+    // The smaller one is standard time, north or south of the equator.
+    var year = new Date().getFullYear();
+    var january = -new Date(year, 0, 1).getTimezoneOffset() * 60;
+    var july = -new Date(year, 6, 1).getTimezoneOffset() * 60;
+    var std = Math.min(january, july);
+    var dst = Math.max(january, july);
+    for (var i = 0; i < tzSelect.options.length; i++) {
+      var option = tzSelect.options[i];
+      if (parseInt(option.getAttribute("data-std"), 10) === std &&
+          parseInt(option.getAttribute("data-dst"), 10) === dst) {
+        tzSelect.selectedIndex = i;
+        tzSelect.dispatchEvent(new Event("change"));
+        return;
+      }
+    }
+  });
+});
@@ -0,0 +1,108 @@
+/*
+  ANAVI Word Clock - Brightness Controller Implementation
+  Gamma-corrected brightness ramps between day and night levels
+*/
+
+#include "brightness.h"
+#include "config.h"
+
+// Gamma 2.2 curve: perceptual step -> LED drive level
+static const uint8_t GAMMA[256] PROGMEM = {
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   1,
+      1,   1,   1,   1,   1,   1,   1,   1,   1,   2,   2,   2,   2,   2,   2,   2,
+      3,   3,   3,   3,   3,   4,   4,   4,   4,   5,   5,   5,   5,   6,   6,   6,
+      6,   7,   7,   7,   8,   8,   8,   9,   9,   9,  10,  10,  11,  11,  11,  12,
+     12,  13,  13,  13,  14,  14,  15,  15,  16,  16,  17,  17,  18,  18,  19,  19,
+     20,  20,  21,  22,  22,  23,  23,  24,  25,  25,  26,  26,  27,  28,  28,  29,
+     30,  30,  31,  32,  33,  33,  34,  35,  35,  36,  37,  38,  39,  39,  40,  41,
+     42,  43,  43,  44,  45,  46,  47,  48,  49,  49,  50,  51,  52,  53,  54,  55,
+     56,  57,  58,  59,  60,  61,  62,  63,  64,  65,  66,  67,  68,  69,  70,  71,
+     73,  74,  75,  76,  77,  78,  79,  81,  82,  83,  84,  85,  87,  88,  89,  90,
+     91,  93,  94,  95,  97,  98,  99, 100, 102, 103, 105, 106, 107, 109, 110, 111,
+    113, 114, 116, 117, 119, 120, 121, 123, 124, 126, 127, 129, 130, 132, 133, 135,
+    137, 138, 140, 141, 143, 145, 146, 148, 149, 151, 153, 154, 156, 158, 159, 161,
+    163, 165, 166, 168, 170, 172, 173, 175, 177, 179, 181, 182, 184, 186, 188, 190,
+    192, 194, 196, 197, 199, 201, 203, 205, 207, 209, 211, 213, 215, 217, 219, 221,
+    223, 225, 227, 229, 231, 234, 236, 238, 240, 242, 244, 246, 248, 251, 253, 255
+};
+
+BrightnessController::BrightnessController()
+    : level(0)
+    , target(0)
+    , fromIndex(0)
+    , toIndex(0)
+    , rampStart(0)
+    , rampDuration(BRIGHTNESS_RAMP_MS)
+    , ramping(false)
+{
+}
+
+uint8_t BrightnessController::perceptualIndex(uint8_t level)
+{
+    // Smallest perceptual step that drives at least this level
+    uint8_t low = 0;
+    uint8_t high = 255;
+    while (low < high)
+    {
+        const uint8_t mid = low + (high - low) / 2;
+        if (pgm_read_byte(&GAMMA[mid]) < level)
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+void BrightnessController::setTarget(uint8_t newTarget, unsigned long nowMs)
+{
+    if (newTarget == target)
+    {
+        return;
+    }
+    target = newTarget;
+    if (0 == rampDuration)
+    {
+        jumpTo(newTarget);
+        return;
+    }
+    fromIndex = perceptualIndex(level);
+    toIndex = perceptualIndex(newTarget);
+    rampStart = nowMs;
+    ramping = true;
+}
+
+void BrightnessController::jumpTo(uint8_t newTarget)
+{
+    level = newTarget;
+    target = newTarget;
+    ramping = false;
+}
+
+bool BrightnessController::update(unsigned long nowMs)
+{
+    if (!ramping)
+    {
+        return false;
+    }
+
+    const uint8_t previous = level;
+    const unsigned long elapsed = nowMs - rampStart;
+    if (elapsed >= rampDuration)
+    {
+        level = target;
+        ramping = false;
+    }
+    else
+    {
+        // Q16 progress along the perceptual scale
+        const uint32_t progress = ((uint32_t)elapsed << 16) / rampDuration;
+        const int16_t span = (int16_t)toIndex - (int16_t)fromIndex;
+        const uint8_t index = fromIndex + (int16_t)((span * (int32_t)progress) >> 16);
+        level = pgm_read_byte(&GAMMA[index]);
+    }
+    return level != previous;
+}
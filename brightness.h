@@ -0,0 +1,41 @@
+/*
+  ANAVI Word Clock - Brightness Controller Header
+  Gamma-corrected brightness ramps between day and night levels
+*/
+
+#ifndef BRIGHTNESS_CONTROLLER_H
+#define BRIGHTNESS_CONTROLLER_H
+
+#include <Arduino.h>
+
+class BrightnessController {
+public:
+    // Constructor
+    BrightnessController();
+
+    // Start ramping towards a new level. Does nothing when the level is
+    // already the target.
+    void setTarget(uint8_t target, unsigned long nowMs);
+
+    // Set the level at once, cancelling any ramp
+    void jumpTo(uint8_t target);
+
+    // Advance the ramp. Returns true when the output level changed.
+    bool update(unsigned long nowMs);
+
+    uint8_t getLevel() const { return level; }
+
+private:
+    uint8_t level;
+    uint8_t target;
+    // Ramp end points on the perceptual (gamma-encoded) scale
+    uint8_t fromIndex;
+    uint8_t toIndex;
+    unsigned long rampStart;
+    uint16_t rampDuration;  // BRIGHTNESS_RAMP_MS
+    bool ramping;
+
+    static uint8_t perceptualIndex(uint8_t level);
+};
+
+#endif // BRIGHTNESS_CONTROLLER_H
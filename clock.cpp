@@ -5,483 +5,435 @@
 
 #include "clock.h"
 #include "config.h"
+#include "perf.h"
 #include <Arduino.h>
 
-// Word mask definitions (64-bit masks for 8x8 matrix)
-#define MASK_MFIVE    0xF0000000000ULL
-#define MASK_MTEN     0x1A00000000000000ULL
-#define MASK_AQUARTER 0x1FE000000000000ULL
-#define MASK_TWENTY   0x7E00000000000000ULL
-#define MASK_HALF     0xF00000000000ULL
-#define MASK_PAST     0x7800000000ULL
-#define MASK_TO       0xC00000000ULL
-#define MASK_ONE      0x43ULL
-#define MASK_TWO      0x340ULL
-#define MASK_THREE    0x1F0000ULL
-#define MASK_FOUR     0xF0ULL
-#define MASK_FIVE     0xF000000ULL
-#define MASK_SIX      0xE00000ULL
-#define MASK_SEVEN    0x80F000ULL
-#define MASK_EIGHT    0xF8000000ULL
-#define MASK_NINE     0xFULL
-#define MASK_TEN      0x80018000ULL
-#define MASK_ELEVEN   0xFC00ULL
-#define MASK_TWELVE   0x6F00ULL
-#define MASK_ANAVI    0x1100200000002004ULL
-#define MASK_WIFI     0x400020003000000ULL
-#define MASK_HA       0x300000000000ULL
-
-WordClock::WordClock()
-    : matrix(8, 8, NEOPIN,
-             NEO_MATRIX_TOP  + NEO_MATRIX_LEFT +
-             NEO_MATRIX_ROWS + NEO_MATRIX_ZIGZAG,
-             NEO_GRB         + NEO_KHZ800)
-    , mask(0)
-    , colorShift(0)
-    , dayBrightness(40)
-    , nightBrightness(20)
-    , morningCutoff(7)
-    , nightCutoff(22)
-    , flashDelay(100)
-    , shiftDelay(100)
+// Rainbow palette: the 5-6-5 quantized color wheel widened back to RGB888,
+// so the colors match what the panel has always shown
+static constexpr uint16_t color565(uint8_t r, uint8_t g, uint8_t b)
 {
+    return ((uint16_t)(r & 0xF8) << 8) | ((uint16_t)(g & 0xFC) << 3) | (b >> 3);
 }
 
-void WordClock::begin()
+static constexpr uint32_t expand565(uint16_t color)
 {
-    matrix.begin();
-    matrix.setBrightness(dayBrightness);
-    matrix.fillScreen(0);
-    matrix.show();
+    return ((uint32_t)(color & 0xF800) << 8) |
+           ((uint32_t)(color & 0x07E0) << 5) |
+           ((uint32_t)(color & 0x001F) << 3);
 }
 
-void WordClock::setBrightness(uint8_t brightness)
+static constexpr uint32_t wheelColor(uint8_t wheelPos)
 {
-    matrix.setBrightness(brightness);
+    return expand565(wheelPos < 85  ? color565(255 - wheelPos * 3, 0, wheelPos * 3) :
+                     wheelPos < 170 ? color565(0, (wheelPos - 85) * 3, 255 - (wheelPos - 85) * 3) :
+                                      color565((wheelPos - 170) * 3, 255 - (wheelPos - 170) * 3, 0));
 }
 
-void WordClock::applyMask()
+struct Palette {
+    uint32_t colors[256];
+};
+
+static constexpr Palette buildPalette()
 {
-    for (byte i = 0; i < 64; i++)
+    Palette palette = {};
+    for (uint16_t i = 0; i < 256; i++)
     {
-        // bitread is backwards because bitRead reads rightmost digits first
-        boolean masker = bitRead(mask, 63 - i);
-        switch (masker)
-        {
-            case 0:
-                matrix.setPixelColor(i, 0, 0, 0);
-                break;
-            case 1:
-                matrix.setPixelColor(i, Wheel(((i * 256 / matrix.numPixels()) + colorShift) & 255));
-                break;
-        }
+        palette.colors[i] = wheelColor(255 - i);
     }
+    return palette;
+}
 
-    matrix.show();
-    delay(shiftDelay);
-    colorShift++;
-    colorShift = colorShift % (256 * 5);
+static constexpr Palette PALETTE = buildPalette();
 
-    // reset mask for next time
-    mask = 0;
+// Palette distance between neighbouring pixels, spreading one full
+// rainbow across the panel
+template <uint16_t CELLS>
+static constexpr uint8_t paletteStep()
+{
+    return CELLS < 256 ? 256 / CELLS : 1;
 }
 
-uint32_t WordClock::Wheel(byte wheelPos)
+// Complete phrase for an hour and five-minute bucket
+template <class FACE>
+static constexpr typename FACE::Mask phraseMask(uint8_t hour, uint8_t bucket)
 {
-    wheelPos = 255 - wheelPos;
-    uint32_t wheelColor;
-
-    if (wheelPos < 85)
-    {
-        wheelColor = matrix.Color(255 - wheelPos * 3, 0, wheelPos * 3);
-    }
-    else if (wheelPos < 170)
-    {
-        wheelPos -= 85;
-        wheelColor = matrix.Color(0, wheelPos * 3, 255 - wheelPos * 3);
-    }
-    else
-    {
-        wheelPos -= 170;
-        wheelColor = matrix.Color(wheelPos * 3, 255 - wheelPos * 3, 0);
-    }
-
-    // convert from 24-bit to 16-bit color
-    uint32_t bits = wheelColor;
-    uint32_t blue = bits & 0x001F;
-    uint32_t green = bits & 0x07E0;
-    uint32_t red = bits & 0xF800;
-
-    return (red << 8) | (green << 5) | (blue << 3) | 0xFF000000;
+    return FACE::MINUTES[bucket] | FACE::HOURS[(hour + (bucket >= FACE::NEXT_HOUR_FROM)) % 12];
 }
 
-void WordClock::rainbowCycle(uint8_t wait)
-{
-    uint16_t i, j;
+template <class FACE>
+struct TimeMaskTable {
+    typename FACE::Mask masks[12][12];
+};
 
-    for (j = 0; j < 256; j++)
+template <class FACE>
+static constexpr TimeMaskTable<FACE> buildTimeMasks()
+{
+    TimeMaskTable<FACE> table = {};
+    for (uint8_t hour = 0; hour < 12; hour++)
     {
-        for (i = 0; i < matrix.numPixels(); i++)
+        for (uint8_t bucket = 0; bucket < 12; bucket++)
         {
-            matrix.setPixelColor(i, Wheel(((i * 256 / matrix.numPixels()) + j) & 255));
+            table.masks[hour][bucket] = phraseMask<FACE>(hour, bucket);
         }
-        matrix.show();
-        delay(wait);
     }
+    return table;
 }
 
-void WordClock::adjustBrightness(const DateTime& currentTime)
+// Word mask for every displayable time, built at compile time
+template <class FACE>
+static constexpr TimeMaskTable<FACE> TIME_MASKS = buildTimeMasks<FACE>();
+
+using English = Faceplate<FACEPLATE_EN_8X8>;
+static_assert(TIME_MASKS<English>.masks[0][0] == English::TWELVE, "midnight reads twelve");
+static_assert(TIME_MASKS<English>.masks[3][6] == (English::HALF | English::PAST | English::THREE),
+              "half past three");
+static_assert(TIME_MASKS<English>.masks[11][11] == (English::MFIVE | English::TO | English::TWELVE),
+              "five to twelve");
+
+using EnglishLarge = Faceplate<FACEPLATE_EN_11X10>;
+static_assert(TIME_MASKS<EnglishLarge>.masks[3][0] ==
+              (EnglishLarge::ITIS | EnglishLarge::THREE | EnglishLarge::OCLOCK),
+              "it is three o'clock");
+
+// Words around the phrase: none on the 8x8 face, "it is" and "o'clock" on the large one
+static constexpr English::Mask baselineFrame(const English*, bool)
 {
-    if (currentTime.hour() < morningCutoff || currentTime.hour() > nightCutoff)
-    {
-        matrix.setBrightness(nightBrightness);
-    }
-    else
-    {
-        matrix.setBrightness(dayBrightness);
-    }
+    return English::Mask();
 }
 
-void WordClock::displayTime(const DateTime& currentTime)
+static constexpr EnglishLarge::Mask baselineFrame(const EnglishLarge*, bool oclock)
 {
-    // Display the appropriate minute counter
-    if ((currentTime.minute() > 4) && (currentTime.minute() < 10))
+    return EnglishLarge::ITIS | (oclock ? EnglishLarge::OCLOCK : EnglishLarge::Mask());
+}
+
+// The minute ranges and hour switch displayTime() used to walk every call
+template <class FACE>
+static constexpr typename FACE::Mask baselineTimeMask(uint8_t hour, uint8_t minute)
+{
+    typedef typename FACE::Mask Mask;
+    const Mask hours[12] = {
+        FACE::TWELVE, FACE::ONE, FACE::TWO, FACE::THREE, FACE::FOUR, FACE::FIVE,
+        FACE::SIX, FACE::SEVEN, FACE::EIGHT, FACE::NINE, FACE::TEN, FACE::ELEVEN
+    };
+    Mask mask = baselineFrame(static_cast<const FACE*>(nullptr), minute < 5);
+    if ((minute > 4) && (minute < 10))
     {
-        setMFive();
+        mask |= FACE::MFIVE;
     }
-    if ((currentTime.minute() > 9) && (currentTime.minute() < 15))
+    if ((minute > 9) && (minute < 15))
     {
-        setMTen();
+        mask |= FACE::MTEN;
     }
-    if ((currentTime.minute() > 14) && (currentTime.minute() < 20))
+    if ((minute > 14) && (minute < 20))
     {
-        setAQuarter();
+        mask |= FACE::AQUARTER;
     }
-    if ((currentTime.minute() > 19) && (currentTime.minute() < 25))
+    if ((minute > 19) && (minute < 25))
     {
-        setTwenty();
+        mask |= FACE::TWENTY;
     }
-    if ((currentTime.minute() > 24) && (currentTime.minute() < 30))
+    if ((minute > 24) && (minute < 30))
     {
-        setTwenty();
-        setMFive();
+        mask |= FACE::TWENTY | FACE::MFIVE;
     }
-    if ((currentTime.minute() > 29) && (currentTime.minute() < 35))
+    if ((minute > 29) && (minute < 35))
     {
-        setHalf();
+        mask |= FACE::HALF;
     }
-    if ((currentTime.minute() > 34) && (currentTime.minute() < 40))
+    if ((minute > 34) && (minute < 40))
     {
-        setTwenty();
-        setMFive();
+        mask |= FACE::TWENTY | FACE::MFIVE;
     }
-    if ((currentTime.minute() > 39) && (currentTime.minute() < 45))
+    if ((minute > 39) && (minute < 45))
     {
-        setTwenty();
+        mask |= FACE::TWENTY;
     }
-    if ((currentTime.minute() > 44) && (currentTime.minute() < 50))
+    if ((minute > 44) && (minute < 50))
     {
-        setAQuarter();
+        mask |= FACE::AQUARTER;
     }
-    if ((currentTime.minute() > 49) && (currentTime.minute() < 55))
+    if ((minute > 49) && (minute < 55))
     {
-        setMTen();
+        mask |= FACE::MTEN;
     }
-    if (currentTime.minute() > 54)
+    if (minute > 54)
     {
-        setMFive();
+        mask |= FACE::MFIVE;
     }
 
-    if ((currentTime.minute() < 5))
+    if (minute < 5)
     {
-        switch (currentTime.hour())
-        {
-            case 1:
-            case 13:
-                setOne();
-                break;
-            case 2:
-            case 14:
-                setTwo();
-                break;
-            case 3:
-            case 15:
-                setThree();
-                break;
-            case 4:
-            case 16:
-                setFour();
-                break;
-            case 5:
-            case 17:
-                setFive();
-                break;
-            case 6:
-            case 18:
-                setSix();
-                break;
-            case 7:
-            case 19:
-                setSeven();
-                break;
-            case 8:
-            case 20:
-                setEight();
-                break;
-            case 9:
-            case 21:
-                setNine();
-                break;
-            case 10:
-            case 22:
-                setTen();
-                break;
-            case 11:
-            case 23:
-                setEleven();
-                break;
-            case 0:
-            case 12:
-                setTwelve();
-                break;
-        }
+        mask |= hours[hour % 12];
     }
-    else if ((currentTime.minute() < 35) && (currentTime.minute() > 4))
+    else if (minute < 35)
     {
-        setPast();
-        switch (currentTime.hour())
-        {
-            case 1:
-            case 13:
-                setOne();
-                break;
-            case 2:
-            case 14:
-                setTwo();
-                break;
-            case 3:
-            case 15:
-                setThree();
-                break;
-            case 4:
-            case 16:
-                setFour();
-                break;
-            case 5:
-            case 17:
-                setFive();
-                break;
-            case 6:
-            case 18:
-                setSix();
-                break;
-            case 7:
-            case 19:
-                setSeven();
-                break;
-            case 8:
-            case 20:
-                setEight();
-                break;
-            case 9:
-            case 21:
-                setNine();
-                break;
-            case 10:
-            case 22:
-                setTen();
-                break;
-            case 11:
-            case 23:
-                setEleven();
-                break;
-            case 0:
-            case 12:
-                setTwelve();
-                break;
-        }
+        mask |= FACE::PAST | hours[hour % 12];
     }
     else
     {
-        // if we are greater than 34 minutes past the hour then display
-        // the next hour, as we will be displaying a 'to' sign
-        setTo();
-        switch (currentTime.hour())
+        mask |= FACE::TO | hours[(hour + 1) % 12];
+    }
+    return mask;
+}
+
+// Every hour of the day and every minute against the table
+template <class FACE>
+static constexpr bool matchesBaseline()
+{
+    for (uint8_t hour = 0; hour < 24; hour++)
+    {
+        for (uint8_t minute = 0; minute < 60; minute++)
         {
-            case 1:
-            case 13:
-                setTwo();
-                break;
-            case 14:
-            case 2:
-                setThree();
-                break;
-            case 15:
-            case 3:
-                setFour();
-                break;
-            case 4:
-            case 16:
-                setFive();
-                break;
-            case 5:
-            case 17:
-                setSix();
-                break;
-            case 6:
-            case 18:
-                setSeven();
-                break;
-            case 7:
-            case 19:
-                setEight();
-                break;
-            case 8:
-            case 20:
-                setNine();
-                break;
-            case 9:
-            case 21:
-                setTen();
-                break;
-            case 10:
-            case 22:
-                setEleven();
-                break;
-            case 11:
-            case 23:
-                setTwelve();
-                break;
-            case 0:
-            case 12:
-                setOne();
-                break;
+            if (TIME_MASKS<FACE>.masks[hour % 12][minute / 5] != baselineTimeMask<FACE>(hour, minute))
+            {
+                return false;
+            }
         }
     }
-
-    // Apply phrase mask to colorshift function
-    applyMask();
+    return true;
 }
 
-void WordClock::showStatusWiFi()
-{
-    setWifi();
-    applyMask();
-} 
+static_assert(matchesBaseline<English>(), "TIME_MASKS differs from the displayTime() branch chain");
+static_assert(matchesBaseline<EnglishLarge>(), "TIME_MASKS differs from the displayTime() branch chain");
 
-void WordClock::showStatusHomeAssistant()
+template <class FACE>
+BasicWordClock<FACE>::BasicWordClock()
+    : matrix(FACE::Panel::COLS, FACE::Panel::ROWS, NEOPIN,
+             NEO_MATRIX_TOP  + NEO_MATRIX_LEFT + NEO_MATRIX_ROWS +
+             (FACE::Panel::SERPENTINE ? NEO_MATRIX_ZIGZAG : NEO_MATRIX_PROGRESSIVE),
+             NEO_GRB         + NEO_KHZ800)
+    , output(NEOPIN, CELLS)
+    , mask()
+    , animation(100 * 1000UL, 256 * 5)
+    , colorShift(0)
+    , power(true)
+    , fixedColor(0)
+    , levelChanged(false)
+    , dayBrightness(40)
+    , nightBrightness(20)
+    , morningCutoff(7)
+    , nightCutoff(22)
+    , flashDelay(100)
+    , shownMask()
+    , shownColorShift(-1)
+    , frameDirty(true)
+    , framesShown(0)
+    , framesSkipped(0)
+    , firstFrameMicros(0)
+    , introActive(false)
+    , introWord(0)
+    , introStartedAt(0)
+    , introNextAt(0)
 {
-    setHA();
-    applyMask();
+    memset(frame, 0, sizeof(frame));
 }
 
-void WordClock::flashWords()
+template <class FACE>
+void BasicWordClock<FACE>::begin()
 {
-    setAnavi();
-    applyMask();
-    delay(flashDelay * 2);
-
-    setMFive();
-    applyMask();
-    delay(flashDelay);
-    
-    setMTen();
-    applyMask();
-    delay(flashDelay);
-
-    setAQuarter();
-    applyMask();
-    delay(flashDelay);
+    matrix.begin();
+    output.begin();
+    brightness.jumpTo(dayBrightness);
+    output.setBrightness(brightness.getLevel());
+    matrix.fillScreen(0);
+    output.submit(matrix.getPixels());
+    memset(frame, 0, sizeof(frame));
+    frameDirty = false;
+}
 
-    setTwenty();
-    applyMask();
-    delay(flashDelay);
+template <class FACE>
+void BasicWordClock<FACE>::setBrightness(uint8_t level)
+{
+    brightness.jumpTo(level);
+    output.setBrightness(level);
+    levelChanged = true;
+}
 
-    setHalf();
-    applyMask();
-    delay(flashDelay);
+template <class FACE>
+void BasicWordClock<FACE>::updateBrightness()
+{
+    if (brightness.update(millis()))
+    {
+        output.setBrightness(brightness.getLevel());
+        levelChanged = true;
+    }
+}
 
-    setTo();
-    applyMask();
-    delay(flashDelay);
+template <class FACE>
+void BasicWordClock<FACE>::applyMask()
+{
+    PERF_PROBE(PERF_APPLY_MASK);
+    updateBrightness();
+    animation.update(micros());
+    colorShift = animation.getPhase();
+    const Mask previousMask = frameDirty ? Mask::all() : shownMask;
+    bool changed = levelChanged;
+
+    // Only switch off pixels that were lit in the previous frame
+    previousMask.without(mask).forEach([&](uint16_t i) {
+        frame[i] = 0;
+        matrix.setPixelColor(i, 0);
+        changed = true;
+    });
+
+    // Color the lit pixels along the rainbow
+    mask.forEach([&](uint16_t i) {
+        const uint32_t color = fixedColor ? fixedColor : PALETTE.colors[(i * paletteStep<CELLS>() + colorShift) & 255];
+        if (frameDirty || color != frame[i])
+        {
+            frame[i] = color;
+            matrix.setPixelColor(i, color);
+            changed = true;
+        }
+    });
 
-    setPast();
-    applyMask();
-    delay(flashDelay);
+    if (changed)
+    {
+        PERF_PROBE(PERF_SHOW);
+        output.submit(matrix.getPixels());
+        framesShown++;
+    }
+    else
+    {
+        framesSkipped++;
+    }
+    levelChanged = false;
+    frameDirty = false;
+    shownMask = mask;
+    shownColorShift = colorShift;
 
-    setOne();
-    applyMask();
-    delay(flashDelay);
+    // reset mask for next time
+    mask = Mask();
+}
 
-    setTwo();
-    applyMask();
-    delay(flashDelay);
-    
-    setThree();
-    applyMask();
-    delay(flashDelay);
-    
-    setFour();
-    applyMask();
-    delay(flashDelay);
 
-    setFive();
-    applyMask();
-    delay(flashDelay);
+template <class FACE>
+void BasicWordClock<FACE>::setPower(bool on)
+{
+    // displayTime() picks the change up on its next pass
+    power = on;
+}
+template <class FACE>
+void BasicWordClock<FACE>::setColor(uint32_t color)
+{
+    if (color != fixedColor)
+    {
+        fixedColor = color;
+        frameDirty = true;
+    }
+}
+template <class FACE>
+void BasicWordClock<FACE>::serviceOutput()
+{
+    output.service();
+}
 
-    setSix();
-    applyMask();
-    delay(flashDelay);
+template <class FACE>
+void BasicWordClock<FACE>::adjustBrightness(const DateTime& currentTime)
+{
+    PERF_PROBE(PERF_ADJUST_BRIGHTNESS);
+    // Only a change of target starts a ramp, the steady state costs nothing
+    if (currentTime.hour() < morningCutoff || currentTime.hour() > nightCutoff)
+    {
+        brightness.setTarget(nightBrightness, millis());
+    }
+    else
+    {
+        brightness.setTarget(dayBrightness, millis());
+    }
+}
 
-    setSeven();
-    applyMask();
-    delay(flashDelay);
+template <class FACE>
+void BasicWordClock<FACE>::displayTime(const DateTime& currentTime)
+{
+    PERF_PROBE(PERF_DISPLAY_TIME);
+    mask = power ? TIME_MASKS<FACE>.masks[currentTime.hour() % 12][currentTime.minute() / 5] : Mask();
+    updateBrightness();
+    animation.update(micros());
+    if (mask == shownMask && animation.getPhase() == shownColorShift && !levelChanged && !frameDirty)
+    {
+        // Neither the words, the animation phase nor the brightness moved
+        mask = Mask();
+        return;
+    }
 
-    setEight();
+    // Apply phrase mask to colorshift function
     applyMask();
-    delay(flashDelay);
+    if (0 == firstFrameMicros)
+    {
+        firstFrameMicros = micros();
+    }
+}
 
-    setNine();
+template <class FACE>
+void BasicWordClock<FACE>::showStatusWiFi()
+{
+    mask = FACE::WIFI;
     applyMask();
-    delay(flashDelay);
+}
 
-    setTen();
+template <class FACE>
+void BasicWordClock<FACE>::showStatusHomeAssistant()
+{
+    mask = FACE::HA;
     applyMask();
-    delay(flashDelay);
+}
 
-    setEleven();
-    applyMask();
-    delay(flashDelay);
+template <class FACE>
+void BasicWordClock<FACE>::startIntro()
+{
+    introActive = true;
+    introWord = 0;
+    introStartedAt = millis();
+}
 
-    setTwelve();
+template <class FACE>
+bool BasicWordClock<FACE>::serviceIntro()
+{
+    if (!introActive)
+    {
+        return false;
+    }
+    const unsigned long now = millis();
+    const unsigned long rainbowStep = (now - introStartedAt) / INTRO_RAINBOW_STEP_MS;
+    if (rainbowStep < 256)
+    {
+        // The rainbow phase follows the clock, not the frame count
+        for (uint16_t i = 0; i < matrix.numPixels(); i++)
+        {
+            matrix.setPixelColor(i, PALETTE.colors[(i * paletteStep<CELLS>() + rainbowStep) & 255]);
+        }
+        output.submit(matrix.getPixels());
+        frameDirty = true;
+        introNextAt = now;
+        return true;
+    }
+    if ((long)(now - introNextAt) < 0)
+    {
+        return true;
+    }
+    if (introWord >= sizeof(FACE::INTRO) / sizeof(FACE::INTRO[0]))
+    {
+        stopIntro();
+        return false;
+    }
+    mask = FACE::INTRO[introWord];
     applyMask();
-    delay(flashDelay);
+    // The logo stays up twice as long as the words
+    introNextAt = now + (0 == introWord ? 2 * flashDelay : flashDelay);
+    introWord++;
+    return true;
+}
 
-    // blank for a bit
-    applyMask();
-    delay(flashDelay);
+template <class FACE>
+void BasicWordClock<FACE>::stopIntro()
+{
+    if (introActive)
+    {
+        introActive = false;
+        // The pixel buffer no longer matches the last pushed frame
+        frameDirty = true;
+    }
 }
 
-// Word mask setter methods
-void WordClock::setMFive()    { mask |= MASK_MFIVE; }
-void WordClock::setMTen()     { mask |= MASK_MTEN; }
-void WordClock::setAQuarter() { mask |= MASK_AQUARTER; }
-void WordClock::setTwenty()   { mask |= MASK_TWENTY; }
-void WordClock::setHalf()     { mask |= MASK_HALF; }
-void WordClock::setPast()     { mask |= MASK_PAST; }
-void WordClock::setTo()       { mask |= MASK_TO; }
-void WordClock::setOne()      { mask |= MASK_ONE; }
-void WordClock::setTwo()      { mask |= MASK_TWO; }
-void WordClock::setThree()    { mask |= MASK_THREE; }
-void WordClock::setFour()     { mask |= MASK_FOUR; }
-void WordClock::setFive()     { mask |= MASK_FIVE; }
-void WordClock::setSix()      { mask |= MASK_SIX; }
-void WordClock::setSeven()    { mask |= MASK_SEVEN; }
-void WordClock::setEight()    { mask |= MASK_EIGHT; }
-void WordClock::setNine()     { mask |= MASK_NINE; }
-void WordClock::setTen()      { mask |= MASK_TEN; }
-void WordClock::setEleven()   { mask |= MASK_ELEVEN; }
-void WordClock::setTwelve()   { mask |= MASK_TWELVE; }
-void WordClock::setAnavi()    { mask |= MASK_ANAVI; }
-void WordClock::setWifi()     { mask |= MASK_WIFI; }
-void WordClock::setHA()       { mask |= MASK_HA; }
+template class BasicWordClock<Faceplate<FACEPLATE>>;
@@ -8,20 +8,35 @@
 
 #include <Adafruit_NeoMatrix.h>
 #include <RTClib.h>
+#include "config.h"
+#include "faceplate.h"
+#include "led_output.h"
+#include "brightness.h"
+#include "animation.h"
 
-class WordClock {
+// Word clock for the faceplate FACE. The panel size and strip wiring come
+// from FACE::Panel, so every mask operation is sized at compile time.
+template <class FACE>
+class BasicWordClock {
 public:
+    using Mask = typename FACE::Mask;
+    static constexpr uint16_t CELLS = FACE::Panel::CELLS;
+    static_assert(CELLS <= LED_MAX_PIXELS, "raise LED_MAX_PIXELS for this faceplate");
+
     // Constructor
-    WordClock();
+    BasicWordClock();
     
     // Public methods used in setup() and loop()
     void begin();
 
     void setBrightness(uint8_t brightness);
 
-    void rainbowCycle(uint8_t wait);
-
-    void flashWords();
+    // Startup rainbow and word test, played frame by frame from the
+    // render tick. serviceIntro() returns true while it still owns the
+    // display; stopIntro() cuts it short.
+    void startIntro();
+    bool serviceIntro();
+    void stopIntro();
 
     void adjustBrightness(const DateTime& currentTime);
 
@@ -30,50 +45,77 @@ public:
     void showStatusWiFi();
 
     void showStatusHomeAssistant();
+
+    // Blank the words while off; a color of 0 keeps the rainbow
+    void setPower(bool on);
+    void setColor(uint32_t color);
+
+    // Words and brightness level currently on the LEDs
+    const Mask& getWordMask() const { return shownMask; }
+    uint8_t getBrightness() const { return brightness.getLevel(); }
+
+    // Keep the asynchronous LED output moving, call on every loop pass
+    void serviceOutput();
+
+    // Animation frame rate achieved, and the time budget of one frame
+    float getFps() const { return animation.getFps(); }
+    uint32_t getFrameBudgetUs() const { return animation.getFrameBudgetUs(); }
+    uint32_t getFramesDropped() const { return animation.getFramesDropped(); }
+
+    // micros() when the first time frame went out, 0 until then
+    unsigned long getFirstFrameMicros() const { return firstFrameMicros; }
+
+    // Estimated LED supply current, see LedOutput
+    uint16_t getCurrentMa() const { return output.getCurrentMa(); }
+    uint16_t getPeakMa() const { return output.getPeakMa(); }
+    uint16_t getAverageMa() const { return output.getAverageMa(); }
+    uint32_t getFramesLimited() const { return output.getFramesLimited(); }
+
+    // Frames pushed to the LEDs and frames skipped as unchanged
+    uint32_t getFramesShown() const { return framesShown; }
+    uint32_t getFramesSkipped() const { return framesSkipped; }
     
 private:
     // Private member variables
     Adafruit_NeoMatrix matrix;
-    uint64_t mask;
+    LedOutput output;
+    Mask mask;
+    AnimationClock animation;
     int colorShift;
+    bool power;
+    uint32_t fixedColor;
     
     // Brightness settings
+    BrightnessController brightness;
+    bool levelChanged;
     uint8_t dayBrightness;
     uint8_t nightBrightness;
     uint8_t morningCutoff;
     uint8_t nightCutoff;
     
-    // Timing delays
+    // Timing delay
     uint16_t flashDelay;
-    uint16_t shiftDelay;
+
+    // Last frame pushed to the LEDs
+    uint32_t frame[CELLS];
+    Mask shownMask;
+    int shownColorShift;
+    bool frameDirty;
+    uint32_t framesShown;
+    uint32_t framesSkipped;
+    unsigned long firstFrameMicros;
+
+    // Startup intro progress
+    bool introActive;
+    uint8_t introWord;
+    unsigned long introStartedAt;
+    unsigned long introNextAt;
     
     // Private methods
     void applyMask();
-    uint32_t Wheel(byte wheelPos);
-    
-    // Word mask setting methods
-    void setMFive();
-    void setMTen();
-    void setAQuarter();
-    void setTwenty();
-    void setHalf();
-    void setPast();
-    void setTo();
-    void setOne();
-    void setTwo();
-    void setThree();
-    void setFour();
-    void setFive();
-    void setSix();
-    void setSeven();
-    void setEight();
-    void setNine();
-    void setTen();
-    void setEleven();
-    void setTwelve();
-    void setAnavi();
-    void setWifi();
-    void setHA();
+    void updateBrightness();
 };
 
+using WordClock = BasicWordClock<Faceplate<FACEPLATE>>;
+
 #endif // CLOCK_FUNCTIONS_H
@@ -11,24 +11,82 @@
 // ============================================================================
 #define NEOPIN 10  // connect to DIN on NeoMatrix 8x8
 
+// ============================================================================
+// FACEPLATE
+// ============================================================================
+// Letter grid on the front, see faceplate.h
+#define FACEPLATE FACEPLATE_EN_8X8
+
+// ============================================================================
+// LED OUTPUT
+// ============================================================================
+#define LED_MAX_PIXELS 64  // at least the cells of FACEPLATE
+#define LED_MASK_WORDS ((LED_MAX_PIXELS + 63) / 64)
+#define LED_RESET_US 300  // low time that latches a frame (WS2812B V5 needs 280)
+
+// Frames estimated to draw more than the budget are dimmed to fit, which
+// keeps a full-white frame from browning out a weak USB supply. 0 turns
+// the limit off, the estimate is still kept.
+#define LED_POWER_BUDGET_MA 500
+#define LED_CHANNEL_MA 20  // one color channel at full duty
+#define LED_IDLE_MA 1      // per LED with every channel dark
+
 // Configure pins
 const int pinAlarm = D3;
 const int pinButton = D8;
 const int pinExtra = D2;
 
+// ============================================================================
+// BRIGHTNESS
+// ============================================================================
+#define BRIGHTNESS_RAMP_MS 3000  // day/night fade duration, 0 switches at once
+
 // ============================================================================
 // NTP CONFIGURATION
 // ============================================================================
-const char NTP_SERVER[] = "pool.ntp.org";
-const long NTP_OFFSET = 2 * 3600;  // UTC+2 for Bulgaria
+// Every round asks all of them and keeps the reply with the shortest
+// round trip. "name" or "name:port", at most SNTP_MAX_SERVERS.
+const char* const NTP_SERVERS[] = {
+    "0.pool.ntp.org",
+    "1.pool.ntp.org",
+    "2.pool.ntp.org"
+};
+#define SNTP_MAX_SERVERS 4
+#define SNTP_LOCAL_PORT 2390
+#define SNTP_POLL_MIN_S 64          // poll interval while the drift is settling
+#define SNTP_POLL_MAX_S 1024        // poll interval once it is stable
+#define SNTP_STABLE_US 2000         // residual that lengthens the poll interval
+#define SNTP_TIMEOUT_MS 1500        // replies later than this miss the round
+#define SNTP_RETRY_S 16             // next round after one without a reply
+#define SNTP_STEP_THRESHOLD_MS 500  // larger offsets step, smaller ones slew
+#define SNTP_SLEW_PPM 500           // slew rate and drift correction limit
+#define SNTP_DNS_TTL_S 3600         // server addresses are looked up again after this
+#define SNTP_HOLDOVER_PPM 20        // wander of the disciplined clock without samples
+
+// ============================================================================
+// RTC HOLDOVER
+// ============================================================================
+// Keep time in a battery-backed RTC for power cycles and network outages.
+// A board without the chip is detected at boot and runs on SNTP alone.
+#define RTC_HOLDOVER
+#define RTC_CHIP RTC_DS3231
+#define RTC_DRIFT_PPM 2              // crystal tolerance of RTC_CHIP
+#define RTC_READ_INTERVAL_MS 60000   // I2C reads, interpolated with millis() between
+#define RTC_SET_INTERVAL_S 86400     // set from SNTP at least this often
+#define RTC_ALIGN_US 20000           // writes land this close after an SNTP second
+#define TIME_HOLD_MAX_S 2            // hold the time instead of stepping back this far
 
 // ============================================================================
 // DST RULES
 // ============================================================================
-// Define US or EU rules for DST comment out as required
-// More countries could be added with different rules in DST_RTC.cpp
+// Define US or EU rules for DST, or none, comment out as required
+// The portal stores a POSIX TZ rule per zone (e.g. "CET-1CEST,M3.5.0,M10.5.0/3"),
+// which carries its own, see time_zone.h. These rules only complete a
+// timezone given as hours east of UTC (e.g. "+2"), as older firmware
+// stored it or as sent over MQTT; it is then stored as the rule they make.
 const char rulesDST[] = "US"; // US DST rules
 // const char rulesDST[] = "EU";   // EU DST rules
+// const char rulesDST[] = "";     // no DST
 
 // ============================================================================
 // DEFAULT MQTT CONFIGURATION
@@ -49,22 +107,84 @@ const char rulesDST[] = "US"; // US DST rules
 // ============================================================================
 #define DEFAULT_TEMP_SCALE "celsius"
 
+// ============================================================================
+// DEFAULT TIMEZONE
+// ============================================================================
+#define DEFAULT_TIMEZONE "EET-2EEST,M3.5.0/3,M10.5.0/4"  // Bulgaria, EU DST
+
 // ============================================================================
 // WIFI CONFIGURATION
 // ============================================================================
 #define WIFI_CONFIG_TIMEOUT 300  // seconds
+#define WIFI_CONNECT_TIMEOUT_MS 20000  // stored credentials, then the portal opens
 #define WIFI_AP_NAME_PREFIX "ANAVI Word Clock "
+#define PORTAL_CHUNK_SIZE 256  // chunked HTTP writes of the generated portal parts
+
+// ============================================================================
+// MQTT CONNECTION SETTINGS
+// ============================================================================
+#define MQTT_BACKOFF_MIN_MS 1000       // first retry after a failure
+#define MQTT_BACKOFF_MAX_MS 60000      // retry interval cap
+#define MQTT_KEEPALIVE 30              // seconds
+#define MQTT_CONNECT_TIMEOUT_MS 5000   // DNS lookup and TCP connect, polled without blocking
+#define MQTT_SOCKET_TIMEOUT 1          // seconds to wait for CONNACK once connected
 
 // ============================================================================
-// MQTT RECONNECTION SETTINGS
+// STATE PUBLISHING
 // ============================================================================
-#define MQTT_RECONNECT_ATTEMPTS 3
-#define MQTT_RECONNECT_DELAY 5000  // milliseconds
+#define STATE_COALESCE_MS 500        // changes within this window share a message
+#define STATE_MIN_INTERVAL_MS 5000   // at most one stat/<id>/state per interval
+#define STATE_UPTIME_MS 60000        // refresh the uptime even when idle
+
+// ============================================================================
+// SCHEDULER TICK PERIODS
+// ============================================================================
+#define RENDER_TICK_MS 10  // samples the animation clock, frames are 100 ms
+#define LED_TICK_MS 0      // every pass, starts queued LED frames
+#define NTP_TICK_MS 0      // every pass, so SNTP replies are stamped on arrival
+#define MQTT_TICK_MS 0     // every pass through loop()
+#define INPUT_TICK_MS 20   // also debounces the button
+
+// ============================================================================
+// TASKS
+// ============================================================================
+// Comment out to run everything from loop() on the cooperative scheduler.
+// With it, the renderer has a task of its own woken every RENDER_TICK_MS,
+// and WiFi, SNTP, MQTT and the button run below it in the network task.
+// Should a task fail to start, the clock falls back to loop().
+#define RTOS_TASKS
+#define RENDER_TASK_PRIORITY 3   // above the network task and loopTask
+#define RENDER_TASK_STACK 4096
+#define NETWORK_TASK_PRIORITY 1  // level of loopTask, well below the WiFi driver
+#define NETWORK_TASK_STACK 8192  // portal, OTA and the JSON documents
+#define NETWORK_TICK_MS 1        // network pass period
+#define TASK_CORE 0              // the ESP32-C3 has a single core
+
+// Queues between the two sides, each a power of two
+#define DISPLAY_COMMAND_QUEUE 16  // network side to renderer
+#define DISPLAY_REPORT_QUEUE 4    // renderer to network side
+#define DISPLAY_REPORT_MS 1000    // LED power estimate refresh
+
+// ============================================================================
+// PERFORMANCE PROBES
+// ============================================================================
+// Uncomment to build the loop stage latency histograms (see perf.h)
+// #define PERF_PROBES
+#define PERF_REPORT_MS 60000  // dump over Serial and publish on stat/<id>/perf
+#define PERF_PAYLOAD_SIZE 320
+
+// ============================================================================
+// BOOT
+// ============================================================================
+// Uncomment to play the rainbow and word test before the time; any button
+// press skips it. Off, the time is up as soon as it is known.
+// #define BOOT_ANIMATION
+#define INTRO_RAINBOW_STEP_MS 5
 
 // ============================================================================
 // FACTORY RESET TIMING
 // ============================================================================
-#define FACTORY_RESET_WAIT_ITERATIONS 40
+#define FACTORY_RESET_WINDOW_MS 4000  // after power on, the alarm LED blinks
 #define FACTORY_RESET_HOLD_ITERATIONS 30
 #define FACTORY_RESET_BLINK_DELAY 50
 #define FACTORY_RESET_HOLD_DELAY 100
@@ -75,11 +195,31 @@ const char rulesDST[] = "US"; // US DST rules
 #define JSON_CONFIG_SIZE 1024
 #define JSON_SMALL_SIZE 100
 #define JSON_SCALE_SIZE 200
+#define JSON_STATE_SIZE (336 + LED_MAX_PIXELS / 4)  // "words" grows with the panel
+
+// /config.json is parsed through a small stack window, values are staged
+// in a buffer as large as the largest config field
+#define CONFIG_READ_WINDOW 64
+#define CONFIG_KEY_MAX 16
+#define CONFIG_VALUE_MAX 49
+
+// ============================================================================
+// CONFIG PERSISTENCE
+// ============================================================================
+#define CONFIG_VERSION 2                      // bump with any ConfigRecord change
+#define CONFIG_NVS_NAMESPACE "wordclock"
+#define CONFIG_NVS_KEY "config"
+#define CONFIG_PATH "/config.json"            // JSON export and migration source
+#define CONFIG_TEMP_PATH "/config.json.tmp"  // staged, then renamed into place
+#define CONFIG_SAVE_DELAY_MS 2000             // folds bursts of changes into one write
 
 // ============================================================================
 // TOPIC BUFFER SIZES
 // ============================================================================
-#define TOPIC_BUFFER_SIZE 200
-#define TOPIC_SMALL_SIZE 50
+// Scratch space for one assembled <workgroup>/<machineId>/<suffix> topic
+#define TOPIC_BUFFER_SIZE 96
+
+// Command dispatch hash slots, a power of two above the command count
+#define COMMAND_SLOTS 16
 
 #endif // CONFIG_H
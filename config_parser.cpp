@@ -0,0 +1,252 @@
+/*
+  ANAVI Word Clock - Config Parser Implementation
+  Streaming, allocation-free reader for the flat /config.json object
+*/
+
+#include "config_parser.h"
+#include "config.h"
+
+namespace {
+
+// Buffered reader over the file, the only storage is a small stack window
+struct ConfigReader {
+    File& file;
+    char window[CONFIG_READ_WINDOW];
+    size_t length;
+    size_t pos;
+
+    explicit ConfigReader(File& in) : file(in), length(0), pos(0) {}
+
+    int next()
+    {
+        if (pos == length)
+        {
+            length = file.read((uint8_t*)window, sizeof(window));
+            pos = 0;
+            if (0 == length)
+            {
+                return -1;
+            }
+        }
+        return (uint8_t)window[pos++];
+    }
+
+    // Push back the character just returned by next()
+    void unread()
+    {
+        pos--;
+    }
+
+    int nextToken()
+    {
+        int c;
+        do
+        {
+            c = next();
+        } while (' ' == c || '\t' == c || '\r' == c || '\n' == c);
+        return c;
+    }
+};
+
+// Append c, or flag the overflow and keep consuming the input
+void append(char* out, size_t size, size_t& used, bool& overflow, char c)
+{
+    if (used + 1 < size)
+    {
+        out[used++] = c;
+    }
+    else
+    {
+        overflow = true;
+    }
+}
+
+// Read the rest of a string after its opening quote
+bool readString(ConfigReader& in, char* out, size_t size, bool& overflow)
+{
+    size_t used = 0;
+    for (;;)
+    {
+        int c = in.next();
+        if (c < 0)
+        {
+            return false;
+        }
+        if ('"' == c)
+        {
+            break;
+        }
+        if ('\\' == c)
+        {
+            c = in.next();
+            switch (c)
+            {
+                case 'n': c = '\n'; break;
+                case 't': c = '\t'; break;
+                case 'r': c = '\r'; break;
+                case 'b': c = '\b'; break;
+                case 'f': c = '\f'; break;
+                case 'u':
+                {
+                    // Only ASCII code points are kept as they are
+                    unsigned int code = 0;
+                    for (uint8_t i = 0; i < 4; i++)
+                    {
+                        const int h = in.next();
+                        if (!isxdigit(h))
+                        {
+                            return false;
+                        }
+                        code = (code << 4) | (isdigit(h) ? h - '0' : (tolower(h) - 'a' + 10));
+                    }
+                    c = (code < 0x80) ? (int)code : '?';
+                    break;
+                }
+                case '"':
+                case '\\':
+                case '/':
+                    break;
+                default:
+                    return false;
+            }
+        }
+        append(out, size, used, overflow, (char)c);
+    }
+    if (size)
+    {
+        out[used] = '\0';
+    }
+    return true;
+}
+
+// Read a number, true, false or null starting with first
+bool readScalar(ConfigReader& in, int first, char* out, size_t size, bool& overflow)
+{
+    size_t used = 0;
+    int c = first;
+    while (isalnum(c) || '-' == c || '+' == c || '.' == c)
+    {
+        append(out, size, used, overflow, (char)c);
+        c = in.next();
+    }
+    if (0 == used && !overflow)
+    {
+        return false;
+    }
+    if (c >= 0)
+    {
+        in.unread();
+    }
+    out[used] = '\0';
+    return true;
+}
+
+// Skip an object or array value whose opening bracket was just read
+bool skipNested(ConfigReader& in)
+{
+    uint8_t depth = 1;
+    while (depth)
+    {
+        const int c = in.next();
+        bool overflow;
+        if (c < 0 || ('"' == c && !readString(in, nullptr, 0, overflow)))
+        {
+            return false;
+        }
+        if ('{' == c || '[' == c)
+        {
+            depth++;
+        }
+        else if ('}' == c || ']' == c)
+        {
+            depth--;
+        }
+    }
+    return true;
+}
+
+const ConfigField* findField(const ConfigField* fields, uint8_t count, const char* key)
+{
+    for (uint8_t i = 0; i < count; i++)
+    {
+        if (0 == strcmp(fields[i].key, key))
+        {
+            return &fields[i];
+        }
+    }
+    return nullptr;
+}
+
+} // namespace
+
+bool parseConfig(File& file, const ConfigField* fields, uint8_t count)
+{
+    ConfigReader in(file);
+    if ('{' != in.nextToken())
+    {
+        return false;
+    }
+    int c = in.nextToken();
+    if ('}' == c)
+    {
+        return true;
+    }
+    for (;;)
+    {
+        char key[CONFIG_KEY_MAX];
+        bool overflow = false;
+        if ('"' != c || !readString(in, key, sizeof(key), overflow))
+        {
+            return false;
+        }
+        const ConfigField* field = overflow ? nullptr : findField(fields, count, key);
+        if (':' != in.nextToken())
+        {
+            return false;
+        }
+
+        // Stage the value so a rejected one cannot clobber the default
+        char value[CONFIG_VALUE_MAX];
+        overflow = false;
+        c = in.nextToken();
+        if ('{' == c || '[' == c)
+        {
+            // Nothing in the config is structured, step over it
+            if (!skipNested(in))
+            {
+                return false;
+            }
+            field = nullptr;
+            value[0] = '\0';
+        }
+        else if (!(('"' == c) ? readString(in, value, sizeof(value), overflow)
+                              : readScalar(in, c, value, sizeof(value), overflow)))
+        {
+            return false;
+        }
+        const bool quoted = ('"' == c);
+        if (field && !(!quoted && 0 == strcmp(value, "null")))
+        {
+            if (overflow || strlen(value) >= field->size)
+            {
+                Serial.print("config value too long, ignored: ");
+                Serial.println(field->key);
+            }
+            else
+            {
+                strcpy(field->value, value);
+            }
+        }
+
+        c = in.nextToken();
+        if ('}' == c)
+        {
+            return true;
+        }
+        if (',' != c)
+        {
+            return false;
+        }
+        c = in.nextToken();
+    }
+}
@@ -0,0 +1,26 @@
+/*
+  ANAVI Word Clock - Config Parser Header
+  Streaming, allocation-free reader for the flat /config.json object
+*/
+
+#ifndef CONFIG_PARSER_H
+#define CONFIG_PARSER_H
+
+#include <Arduino.h>
+#include <FS.h>
+
+// One destination for a string value. size includes the terminating NUL.
+struct ConfigField {
+    const char* key;
+    char* value;
+    size_t size;
+};
+
+// Parse a flat JSON object of scalars from file in one pass, copying each
+// value whose key is in fields into its destination. Values that do not
+// fit are rejected and leave the destination untouched, unknown keys and
+// null values are skipped. Returns false on a syntax error; fields seen
+// before the error keep their new values.
+bool parseConfig(File& file, const ConfigField* fields, uint8_t count);
+
+#endif // CONFIG_PARSER_H
@@ -0,0 +1,166 @@
+/*
+  ANAVI Word Clock - Config Store Implementation
+  Versioned binary config record in NVS, with a JSON export on SPIFFS
+*/
+
+#include "config_store.h"
+#include "config.h"
+#include <Preferences.h>
+#include <SPIFFS.h>
+
+ConfigStore::ConfigStore(const char* path, const char* tempPath)
+    : path(path)
+    , tempPath(tempPath)
+    , mounted(false)
+    , stored(false)
+    , storedCrc(0)
+    , savePending(false)
+    , saveDueAt(0)
+    , writes(0)
+    , skipped(0)
+{
+}
+
+uint32_t ConfigStore::crc32(const uint8_t* data, size_t length)
+{
+    // Bitwise CRC-32 (IEEE), a few microseconds for one record
+    uint32_t crc = 0xFFFFFFFFUL;
+    while (length--)
+    {
+        crc ^= *data++;
+        for (uint8_t bit = 0; bit < 8; bit++)
+        {
+            crc = (crc >> 1) ^ (0xEDB88320UL & (0 - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+bool ConfigStore::load(ConfigRecord& record)
+{
+    Preferences prefs;
+    if (!prefs.begin(CONFIG_NVS_NAMESPACE, true))
+    {
+        return false;
+    }
+    const size_t length = prefs.getBytes(CONFIG_NVS_KEY, &record, sizeof(record));
+    prefs.end();
+    if (sizeof(record) != length
+        || CONFIG_VERSION != record.version
+        || sizeof(record) != record.size
+        || crc32((const uint8_t*)&record, offsetof(ConfigRecord, crc)) != record.crc)
+    {
+        return false;
+    }
+    stored = true;
+    storedCrc = record.crc;
+    return true;
+}
+
+bool ConfigStore::save(ConfigRecord& record)
+{
+    savePending = false;
+    record.version = CONFIG_VERSION;
+    record.size = sizeof(record);
+    record.crc = crc32((const uint8_t*)&record, offsetof(ConfigRecord, crc));
+    if (stored && record.crc == storedCrc)
+    {
+        skipped++;
+        return false;
+    }
+
+    Serial.println("saving config");
+    Preferences prefs;
+    if (!prefs.begin(CONFIG_NVS_NAMESPACE, false)
+        || sizeof(record) != prefs.putBytes(CONFIG_NVS_KEY, &record, sizeof(record)))
+    {
+        Serial.println("failed to write config to NVS");
+        prefs.end();
+        return false;
+    }
+    prefs.end();
+    stored = true;
+    storedCrc = record.crc;
+    writes++;
+    return true;
+}
+
+bool ConfigStore::mountFileSystem(bool formatOnFail)
+{
+    if (!mounted)
+    {
+        Serial.println("mounting FS...");
+        mounted = SPIFFS.begin(formatOnFail);
+        Serial.println(mounted ? "mounted file system" : "failed to mount FS");
+    }
+    return mounted;
+}
+
+void ConfigStore::recover()
+{
+    if (!SPIFFS.exists(tempPath))
+    {
+        return;
+    }
+    if (SPIFFS.exists(path))
+    {
+        // Reset while the new file was written, the old one still stands
+        Serial.println("discarding partial config write");
+        SPIFFS.remove(tempPath);
+    }
+    else
+    {
+        // Reset between removing the old file and renaming the new one
+        Serial.println("completing interrupted config write");
+        SPIFFS.rename(tempPath, path);
+    }
+}
+
+void ConfigStore::requestSave(unsigned long nowMs)
+{
+    savePending = true;
+    saveDueAt = nowMs + CONFIG_SAVE_DELAY_MS;
+}
+
+bool ConfigStore::isSaveDue(unsigned long nowMs) const
+{
+    return savePending && (long)(nowMs - saveDueAt) >= 0;
+}
+
+bool ConfigStore::exportJson(const JsonDocument& json)
+{
+    // Never formats: a file system that does not mount may still hold the
+    // migration source, and the record in NVS is what counts
+    if (!mountFileSystem(false))
+    {
+        Serial.println("skipping config export");
+        return false;
+    }
+    File configFile = SPIFFS.open(tempPath, "w");
+    if (!configFile)
+    {
+        Serial.println("failed to open config file for writing");
+        return false;
+    }
+    serializeJson(json, Serial);
+    Serial.println("");
+    const size_t length = serializeJson(json, configFile);
+    const bool complete = (length > 0 && configFile.size() == length);
+    configFile.close();
+    if (!complete)
+    {
+        Serial.println("failed to write config file");
+        SPIFFS.remove(tempPath);
+        return false;
+    }
+
+    // SPIFFS cannot rename over an existing file. A reset between the two
+    // steps leaves only the new file, which recover() puts in place.
+    SPIFFS.remove(path);
+    if (!SPIFFS.rename(tempPath, path))
+    {
+        Serial.println("failed to rename config file");
+        return false;
+    }
+    return true;
+}
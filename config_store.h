@@ -0,0 +1,77 @@
+/*
+  ANAVI Word Clock - Config Store Header
+  Versioned binary config record in NVS, with a JSON export on SPIFFS
+*/
+
+#ifndef CONFIG_STORE_H
+#define CONFIG_STORE_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+// Image of the configuration kept as a single NVS blob. Every field is
+// present whatever the build options, so the layout only changes together
+// with CONFIG_VERSION.
+struct __attribute__((packed)) ConfigRecord {
+    uint16_t version;
+    uint16_t size;
+    char mqtt_server[40];
+    char mqtt_port[6];
+    char workgroup[32];
+    char username[20];
+    char password[20];
+    uint8_t temp_celsius;   // 1 for celsius, 0 for fahrenheit
+    char timezone[48];
+    char ha_name[33];
+    char ota_server[40];
+    uint32_t crc;   // CRC-32 of everything above
+};
+
+class ConfigStore {
+public:
+    // Constructor, the JSON export lives at path and is staged at tempPath
+    ConfigStore(const char* path, const char* tempPath);
+
+    // Read the record with one NVS access. Returns false when there is
+    // none, or when its version, size or CRC do not match.
+    bool load(ConfigRecord& record);
+
+    // Stamp and store the record unless it matches what is stored.
+    // Returns true when the flash was written.
+    bool save(ConfigRecord& record);
+
+    // Mount SPIFFS on first use, it is not needed to boot from NVS
+    bool mountFileSystem(bool formatOnFail);
+
+    // Finish or discard an export cut short by a reset. Call once the
+    // file system is mounted and before reading path.
+    void recover();
+
+    // Write the human readable copy, atomically
+    bool exportJson(const JsonDocument& json);
+
+    // Ask for a save after the debounce delay, further requests within
+    // the delay are folded into the same write
+    void requestSave(unsigned long nowMs);
+    bool isSaveDue(unsigned long nowMs) const;
+
+    // Saves that wrote the record and saves skipped as identical; the
+    // JSON export that follows a save is not counted again
+    uint32_t getWrites() const { return writes; }
+    uint32_t getSkipped() const { return skipped; }
+
+private:
+    const char* path;
+    const char* tempPath;
+    bool mounted;
+    bool stored;
+    uint32_t storedCrc;
+    bool savePending;
+    unsigned long saveDueAt;
+    uint32_t writes;
+    uint32_t skipped;
+
+    static uint32_t crc32(const uint8_t* data, size_t length);
+};
+
+#endif // CONFIG_STORE_H
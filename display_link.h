@@ -0,0 +1,47 @@
+/*
+  ANAVI Word Clock - Display Link Header
+  Messages between the network side and the renderer
+*/
+
+#ifndef DISPLAY_LINK_H
+#define DISPLAY_LINK_H
+
+#include <stdint.h>
+#include "config.h"
+#include "spsc_ring.h"
+
+// Network side to renderer. The renderer keeps its own copy of what it
+// draws from, so a slow network pass never holds up a frame.
+struct DisplayCommand {
+    enum Type : uint8_t {
+        POWER,       // 1 on, 0 off
+        COLOR,       // 0x00RRGGBB, 0 for the rainbow
+        TIME,        // local time in epoch seconds at queuedUs
+        LINK,        // DISPLAY_LINK_* flags
+        STOP_INTRO
+    };
+    Type type;
+    uint32_t value;
+    unsigned long queuedUs;  // micros() when queued
+};
+
+enum DisplayLinkFlags : uint8_t {
+    DISPLAY_LINK_TIME = 1 << 0,  // a TIME command has been sent
+    DISPLAY_LINK_WIFI = 1 << 1
+};
+
+// Renderer to network side, when what is shown changes and every
+// DISPLAY_REPORT_MS for the power estimate
+struct DisplayReport {
+    uint64_t wordMask[LED_MASK_WORDS];  // pixel 0 in the top bit of the first word
+    uint8_t words;
+    uint8_t brightness;
+    uint16_t averageMa;
+    uint16_t peakMa;
+    unsigned long firstFrameMs;  // boot to the first time frame, 0 before it
+};
+
+typedef SpscRing<DisplayCommand, DISPLAY_COMMAND_QUEUE> DisplayCommandQueue;
+typedef SpscRing<DisplayReport, DISPLAY_REPORT_QUEUE> DisplayReportQueue;
+
+#endif // DISPLAY_LINK_H
@@ -0,0 +1,84 @@
+/*
+  ANAVI Word Clock - DNS Lookup Implementation
+  Looks a name up in the background, polled without ever blocking
+*/
+
+#include "dns_lookup.h"
+#include <lwip/tcpip.h>
+
+DnsLookup::DnsLookup()
+    : state(LOOKUP_IDLE)
+    , address(0)
+{
+    name[0] = '\0';
+}
+
+bool DnsLookup::start(const char* host)
+{
+    if (isPending())
+    {
+        return 0 == strcmp(host, name);
+    }
+    if (strlen(host) >= sizeof(name))
+    {
+        state = LOOKUP_FAILED;
+        return false;
+    }
+    strcpy(name, host);
+    state = LOOKUP_PENDING;
+    // dns_gethostbyname() belongs to the lwIP thread
+    if (ERR_OK != tcpip_callback(startLookup, this))
+    {
+        state = LOOKUP_FAILED;
+        return false;
+    }
+    return true;
+}
+
+void DnsLookup::startLookup(void* arg)
+{
+    DnsLookup* self = static_cast<DnsLookup*>(arg);
+    ip_addr_t found;
+    // Answers right away for a dotted address or a cached name, otherwise
+    // lookupDone() follows once the DNS server replies or times out
+    const err_t err = dns_gethostbyname(self->name, &found, lookupDone, self);
+    if (ERR_OK == err)
+    {
+        lookupDone(self->name, &found, self);
+    }
+    else if (ERR_INPROGRESS != err)
+    {
+        lookupDone(self->name, nullptr, self);
+    }
+}
+
+void DnsLookup::lookupDone(const char* name, const ip_addr_t* found, void* arg)
+{
+    (void)name;
+    DnsLookup* self = static_cast<DnsLookup*>(arg);
+    if (found && IP_IS_V4(found) && 0 != ip4_addr_get_u32(ip_2_ip4(found)))
+    {
+        self->address = ip4_addr_get_u32(ip_2_ip4(found));
+        self->state = LOOKUP_DONE;
+    }
+    else
+    {
+        self->state = LOOKUP_FAILED;
+    }
+}
+
+bool DnsLookup::take(uint32_t& result)
+{
+    switch (state.load())
+    {
+        case LOOKUP_DONE:
+            result = address.load();
+            state = LOOKUP_IDLE;
+            return true;
+        case LOOKUP_FAILED:
+            state = LOOKUP_IDLE;
+            return false;
+        default:
+            return false;
+    }
+}
@@ -0,0 +1,47 @@
+/*
+  ANAVI Word Clock - DNS Lookup Header
+  Looks a name up in the background, polled without ever blocking
+*/
+
+#ifndef DNS_LOOKUP_H
+#define DNS_LOOKUP_H
+
+#include <Arduino.h>
+#include <lwip/dns.h>
+#include <atomic>
+
+// WiFi.hostByName() waits for the DNS server. Here dns_gethostbyname()
+// runs on the lwIP thread, which reports the answer through an atomic
+// the caller polls. The object must outlive a pending lookup.
+class DnsLookup {
+public:
+    DnsLookup();
+
+    // Starts looking the name up. While a lookup is out, the same name
+    // keeps waiting for it and any other name is refused.
+    bool start(const char* name);
+
+    bool isPending() const { return LOOKUP_PENDING == state.load(); }
+
+    // Address of a finished lookup in network byte order, handed out
+    // once; false while pending, after a failure or before any start()
+    bool take(uint32_t& address);
+
+private:
+    enum State : uint8_t {
+        LOOKUP_IDLE,
+        LOOKUP_PENDING,
+        LOOKUP_DONE,
+        LOOKUP_FAILED
+    };
+
+    char name[64];
+    // Written by the lwIP thread while pending
+    std::atomic<uint8_t> state;
+    std::atomic<uint32_t> address;
+
+    static void startLookup(void* arg);
+    static void lookupDone(const char* name, const ip_addr_t* address, void* arg);
+};
+
+#endif // DNS_LOOKUP_H
@@ -0,0 +1,190 @@
+/*
+  ANAVI Word Clock - Faceplate Header
+  Letter grids and the word masks compiled from them
+*/
+
+#ifndef FACEPLATE_H
+#define FACEPLATE_H
+
+#include "word_layout.h"
+
+// Faceplates the firmware knows, picked with FACEPLATE in config.h
+enum FaceplateId : uint8_t {
+    FACEPLATE_EN_8X8,
+    FACEPLATE_EN_11X10
+};
+
+// A faceplate is a specialization of Faceplate<> providing, all constexpr:
+//   Panel            PanelGeometry of the LED matrix behind it
+//   HOURS[12]        hour words indexed by hour % 12
+//   MINUTES[12]      minute words indexed by minute / 5, including the
+//                    words that join them to the hour ("past", "to")
+//   NEXT_HOUR_FROM   first minute bucket that names the coming hour
+//   WIFI, HA         status words
+//   INTRO[]          word test after the startup rainbow, ending with an empty mask
+// Masks are built with WordLayout, which checks every word against the
+// grid while compiling.
+template <FaceplateId ID>
+struct Faceplate;
+
+// English, 8x8
+//
+//   A T W E N T Y D
+//   Q U A R T E R Y
+//   F I V E H A L F
+//   D P A S T O R O
+//   F I V E I G H T
+//   S I X T H R E E
+//   T W E L E V E N
+//   F O U R N I N E
+template <>
+struct Faceplate<FACEPLATE_EN_8X8> {
+    using Panel = PanelGeometry<8, 8, PANEL_SERPENTINE>;
+    using Mask = Panel::Mask;
+
+    static constexpr const char* GRID[Panel::ROWS] = {
+        "ATWENTYD",
+        "QUARTERY",
+        "FIVEHALF",
+        "DPASTORO",
+        "FIVEIGHT",
+        "SIXTHREE",
+        "TWELEVEN",
+        "FOURNINE"
+    };
+    static constexpr WordLayout<Panel> LAYOUT{GRID};
+
+    static constexpr Mask MFIVE    = LAYOUT.span("FIVE", 2, 0);
+    static constexpr Mask MTEN     = LAYOUT.cells("TEN", {{0, 1}, {0, 3}, {0, 4}});
+    static constexpr Mask AQUARTER = LAYOUT.span("A", 0, 0) | LAYOUT.span("QUARTER", 1, 0);
+    static constexpr Mask TWENTY   = LAYOUT.span("TWENTY", 0, 1);
+    static constexpr Mask HALF     = LAYOUT.span("HALF", 2, 4);
+    static constexpr Mask PAST     = LAYOUT.span("PAST", 3, 1);
+    static constexpr Mask TO       = LAYOUT.span("TO", 3, 4);
+    static constexpr Mask ONE      = LAYOUT.cells("ONE", {{7, 1}, {7, 6}, {7, 7}});
+    static constexpr Mask TWO      = LAYOUT.cells("TWO", {{6, 0}, {6, 1}, {7, 1}});
+    static constexpr Mask THREE    = LAYOUT.span("THREE", 5, 3);
+    static constexpr Mask FOUR     = LAYOUT.span("FOUR", 7, 0);
+    static constexpr Mask FIVE     = LAYOUT.span("FIVE", 4, 0);
+    static constexpr Mask SIX      = LAYOUT.span("SIX", 5, 0);
+    static constexpr Mask SEVEN    = LAYOUT.span("S", 5, 0) | LAYOUT.span("EVEN", 6, 4);
+    static constexpr Mask EIGHT    = LAYOUT.span("EIGHT", 4, 3);
+    static constexpr Mask NINE     = LAYOUT.span("NINE", 7, 4);
+    static constexpr Mask TEN      = LAYOUT.cells("TEN", {{4, 7}, {5, 7}, {6, 7}});
+    static constexpr Mask ELEVEN   = LAYOUT.span("ELEVEN", 6, 2);
+    static constexpr Mask TWELVE   = LAYOUT.span("TWEL", 6, 0) | LAYOUT.span("VE", 6, 5);
+    static constexpr Mask ANAVI    = LAYOUT.cells("ANAVI", {{0, 0}, {0, 4}, {2, 5}, {6, 5}, {7, 5}});
+    static constexpr Mask WIFI     = LAYOUT.cells("WIFI", {{0, 2}, {2, 1}, {4, 0}, {4, 1}});
+    static constexpr Mask HA       = LAYOUT.span("HA", 2, 4);
+
+    static constexpr Mask HOURS[12] = {
+        TWELVE, ONE, TWO, THREE, FOUR, FIVE, SIX, SEVEN, EIGHT, NINE, TEN, ELEVEN
+    };
+
+    static constexpr Mask MINUTES[12] = {
+        Mask(),                     // o'clock
+        MFIVE | PAST,               // five past
+        MTEN | PAST,                // ten past
+        AQUARTER | PAST,            // a quarter past
+        TWENTY | PAST,              // twenty past
+        TWENTY | MFIVE | PAST,      // twenty five past
+        HALF | PAST,                // half past
+        TWENTY | MFIVE | TO,        // twenty five to
+        TWENTY | TO,                // twenty to
+        AQUARTER | TO,              // a quarter to
+        MTEN | TO,                  // ten to
+        MFIVE | TO                  // five to
+    };
+
+    // From 35 minutes on the clock reads "... to" the next hour
+    static constexpr uint8_t NEXT_HOUR_FROM = 7;
+
+    static constexpr Mask INTRO[] = {
+        ANAVI, MFIVE, MTEN, AQUARTER, TWENTY, HALF, TO, PAST, ONE, TWO, THREE,
+        FOUR, FIVE, SIX, SEVEN, EIGHT, NINE, TEN, ELEVEN, TWELVE, Mask()
+    };
+};
+
+// English, 11x10, the common large layout
+//
+//   I T L I S A S T I M E
+//   A C Q U A R T E R D C
+//   T W E N T Y F I V E X
+//   H A L F B T E N F T O
+//   P A S T E R U N I N E
+//   O N E S I X T H R E E
+//   F O U R F I V E T W O
+//   E I G H T E L E V E N
+//   S E V E N T W E L V E
+//   T E N S E O C L O C K
+template <>
+struct Faceplate<FACEPLATE_EN_11X10> {
+    using Panel = PanelGeometry<11, 10, PANEL_SERPENTINE>;
+    using Mask = Panel::Mask;
+
+    static constexpr const char* GRID[Panel::ROWS] = {
+        "ITLISASTIME",
+        "ACQUARTERDC",
+        "TWENTYFIVEX",
+        "HALFBTENFTO",
+        "PASTERUNINE",
+        "ONESIXTHREE",
+        "FOURFIVETWO",
+        "EIGHTELEVEN",
+        "SEVENTWELVE",
+        "TENSEOCLOCK"
+    };
+    static constexpr WordLayout<Panel> LAYOUT{GRID};
+
+    static constexpr Mask ITIS     = LAYOUT.span("IT", 0, 0) | LAYOUT.span("IS", 0, 3);
+    static constexpr Mask AQUARTER = LAYOUT.span("A", 1, 0) | LAYOUT.span("QUARTER", 1, 2);
+    static constexpr Mask TWENTY   = LAYOUT.span("TWENTY", 2, 0);
+    static constexpr Mask MFIVE    = LAYOUT.span("FIVE", 2, 6);
+    static constexpr Mask HALF     = LAYOUT.span("HALF", 3, 0);
+    static constexpr Mask MTEN     = LAYOUT.span("TEN", 3, 5);
+    static constexpr Mask TO       = LAYOUT.span("TO", 3, 9);
+    static constexpr Mask PAST     = LAYOUT.span("PAST", 4, 0);
+    static constexpr Mask NINE     = LAYOUT.span("NINE", 4, 7);
+    static constexpr Mask ONE      = LAYOUT.span("ONE", 5, 0);
+    static constexpr Mask SIX      = LAYOUT.span("SIX", 5, 3);
+    static constexpr Mask THREE    = LAYOUT.span("THREE", 5, 6);
+    static constexpr Mask FOUR     = LAYOUT.span("FOUR", 6, 0);
+    static constexpr Mask FIVE     = LAYOUT.span("FIVE", 6, 4);
+    static constexpr Mask TWO      = LAYOUT.span("TWO", 6, 8);
+    static constexpr Mask EIGHT    = LAYOUT.span("EIGHT", 7, 0);
+    static constexpr Mask ELEVEN   = LAYOUT.span("ELEVEN", 7, 5);
+    static constexpr Mask SEVEN    = LAYOUT.span("SEVEN", 8, 0);
+    static constexpr Mask TWELVE   = LAYOUT.span("TWELVE", 8, 5);
+    static constexpr Mask TEN      = LAYOUT.span("TEN", 9, 0);
+    static constexpr Mask OCLOCK   = LAYOUT.span("OCLOCK", 9, 5);
+    static constexpr Mask WIFI     = LAYOUT.cells("WIFI", {{2, 1}, {2, 7}, {3, 8}, {4, 8}});
+    static constexpr Mask HA       = LAYOUT.span("HA", 3, 0);
+
+    static constexpr Mask HOURS[12] = {
+        TWELVE, ONE, TWO, THREE, FOUR, FIVE, SIX, SEVEN, EIGHT, NINE, TEN, ELEVEN
+    };
+
+    static constexpr Mask MINUTES[12] = {
+        ITIS | OCLOCK,                      // o'clock
+        ITIS | MFIVE | PAST,                // five past
+        ITIS | MTEN | PAST,                 // ten past
+        ITIS | AQUARTER | PAST,             // a quarter past
+        ITIS | TWENTY | PAST,               // twenty past
+        ITIS | TWENTY | MFIVE | PAST,       // twenty five past
+        ITIS | HALF | PAST,                 // half past
+        ITIS | TWENTY | MFIVE | TO,         // twenty five to
+        ITIS | TWENTY | TO,                 // twenty to
+        ITIS | AQUARTER | TO,               // a quarter to
+        ITIS | MTEN | TO,                   // ten to
+        ITIS | MFIVE | TO                   // five to
+    };
+
+    static constexpr uint8_t NEXT_HOUR_FROM = 7;
+
+    static constexpr Mask INTRO[] = {
+        ITIS, MFIVE, MTEN, AQUARTER, TWENTY, HALF, TO, PAST, ONE, TWO, THREE, FOUR,
+        FIVE, SIX, SEVEN, EIGHT, NINE, TEN, ELEVEN, TWELVE, OCLOCK, Mask()
+    };
+};
+
+#endif // FACEPLATE_H
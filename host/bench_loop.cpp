@@ -0,0 +1,358 @@
+/*
+  ANAVI Word Clock - loop() latency benchmark for the host build
+
+  Runs setup() once and then times every loop() iteration, both on the
+  simulated clock (which includes delay() and LED wire time) and on the
+  host CPU clock (pure compute). Each pass also charges a small idle step
+  to the simulated clock, standing in for the loopTask overhead, so a run
+  covers a fixed span of device time.
+
+  With --threads the firmware runs as built for the device: setup() starts
+  the render and network tasks as host threads on the real clock, and the
+  bench reports how regularly each task wakes and how long MQTT light
+  commands take to reach the renderer.
+*/
+
+#include <Arduino.h>
+#include "HostSim.h"
+#include "clock.h"
+#include "network.h"
+#include "perf.h"
+#include "scheduler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+void setup();
+void loop();
+
+extern WordClock wordClock;
+extern NetworkConnector networkConnector;
+extern JitterStats commandLatency;
+#ifdef RTOS_TASKS
+extern bool tasksRunning;
+extern JitterStats renderJitter;
+extern JitterStats networkJitter;
+#endif
+
+namespace {
+
+struct Options {
+    unsigned long seconds = 30;
+    unsigned long idleStepUs = 10;
+    uint32_t epoch = 1760000000;
+    // Simulated broker outage, seconds into the run
+    long outageStart = -1;
+    long outageEnd = -1;
+    uint32_t wifiDelayMs = 1500;
+    // Simulated WiFi outage, seconds into the run
+    long wifiOutageStart = -1;
+    long wifiOutageEnd = -1;
+    // RTC fitted and holding a time this far off, none when unset
+    bool rtc = false;
+    long rtcOffsetMs = 0;
+    bool portal = false;
+    bool threads = false;
+    bool verbose = false;
+    // Commands injected on cmnd/<machineId>/<suffix>
+    struct Command {
+        unsigned long second;
+        std::string suffix;
+        std::string payload;
+    };
+    std::vector<Command> commands;
+};
+
+class StdoutPrint : public Print {
+public:
+    size_t write(uint8_t c) override { return fputc(c, stdout) == EOF ? 0 : 1; }
+    using Print::write;
+};
+
+uint64_t cpuNanos()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+double percentile(const std::vector<float>& sorted, double p)
+{
+    if (sorted.empty())
+    {
+        return 0;
+    }
+    size_t index = (size_t)(p / 100.0 * (sorted.size() - 1) + 0.5);
+    return sorted[std::min(index, sorted.size() - 1)];
+}
+
+void report(const char* title, std::vector<float> samples)
+{
+    std::sort(samples.begin(), samples.end());
+    double sum = 0;
+    for (float s : samples)
+    {
+        sum += s;
+    }
+    printf("%s\n", title);
+    printf("  %10s %10s %10s %10s %10s %10s %10s\n",
+           "min", "p50", "p90", "p99", "p99.9", "max", "mean");
+    printf("  %10.1f %10.1f %10.1f %10.1f %10.1f %10.1f %10.1f\n",
+           samples.front(), percentile(samples, 50), percentile(samples, 90),
+           percentile(samples, 99), percentile(samples, 99.9), samples.back(),
+           sum / samples.size());
+}
+
+void reportJitter(const char* title, const JitterStats& stats)
+{
+    printf("%s: %u samples, %u us average, %u us max\n",
+           title, stats.getCount(), stats.getAverageUs(), stats.getMaxUs());
+}
+
+// Outages and commands due elapsedUs into the run
+void serviceScenario(Options& options, uint64_t elapsedUs)
+{
+    const long second = (long)(elapsedUs / 1000000);
+    if (options.outageStart >= 0)
+    {
+        host::setBrokerAvailable(second < options.outageStart || second >= options.outageEnd);
+    }
+    if (options.wifiOutageStart >= 0)
+    {
+        host::setWifiAvailable(second < options.wifiOutageStart || second >= options.wifiOutageEnd);
+    }
+    for (auto it = options.commands.begin(); it != options.commands.end();)
+    {
+        if (elapsedUs < (uint64_t)it->second * 1000000)
+        {
+            ++it;
+            continue;
+        }
+        const std::string topic = std::string("cmnd/") + networkConnector.getMachineId() + "/" + it->suffix;
+        host::mqttInject(topic.c_str(), it->payload.c_str());
+        it = options.commands.erase(it);
+    }
+}
+
+void usage(const char* argv0)
+{
+    fprintf(stderr,
+            "Usage: %s [--seconds N] [--idle-step-us N] [--epoch UNIX_SECONDS]\n"
+            "       [--broker-outage START:END] [--command SECOND:SUFFIX=PAYLOAD]...\n"
+            "       [--wifi-delay-ms N] [--wifi-outage START:END] [--rtc OFFSET_MS]\n"
+            "       [--portal] [--threads] [--verbose]\n",
+            argv0);
+}
+
+bool parseOptions(int argc, char** argv, Options& options)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        const bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "--seconds") == 0 && hasValue)
+        {
+            options.seconds = strtoul(argv[++i], nullptr, 10);
+        }
+        else if (strcmp(argv[i], "--idle-step-us") == 0 && hasValue)
+        {
+            options.idleStepUs = strtoul(argv[++i], nullptr, 10);
+        }
+        else if (strcmp(argv[i], "--epoch") == 0 && hasValue)
+        {
+            options.epoch = strtoul(argv[++i], nullptr, 10);
+        }
+        else if (strcmp(argv[i], "--broker-outage") == 0 && hasValue)
+        {
+            if (sscanf(argv[++i], "%ld:%ld", &options.outageStart, &options.outageEnd) != 2)
+            {
+                return false;
+            }
+        }
+        else if (strcmp(argv[i], "--command") == 0 && hasValue)
+        {
+            const char* spec = argv[++i];
+            const char* colon = strchr(spec, ':');
+            const char* equals = colon ? strchr(colon, '=') : nullptr;
+            if (!equals)
+            {
+                return false;
+            }
+            options.commands.push_back({strtoul(spec, nullptr, 10),
+                                        std::string(colon + 1, equals), std::string(equals + 1)});
+        }
+        else if (strcmp(argv[i], "--wifi-delay-ms") == 0 && hasValue)
+        {
+            options.wifiDelayMs = strtoul(argv[++i], nullptr, 10);
+        }
+        else if (strcmp(argv[i], "--wifi-outage") == 0 && hasValue)
+        {
+            if (sscanf(argv[++i], "%ld:%ld", &options.wifiOutageStart, &options.wifiOutageEnd) != 2)
+            {
+                return false;
+            }
+        }
+        else if (strcmp(argv[i], "--rtc") == 0 && hasValue)
+        {
+            options.rtc = true;
+            options.rtcOffsetMs = strtol(argv[++i], nullptr, 10);
+        }
+        else if (strcmp(argv[i], "--portal") == 0)
+        {
+            options.portal = true;
+        }
+        else if (strcmp(argv[i], "--threads") == 0)
+        {
+            options.threads = true;
+        }
+        else if (strcmp(argv[i], "--verbose") == 0)
+        {
+            options.verbose = true;
+        }
+        else
+        {
+            return false;
+        }
+    }
+    return options.seconds > 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options options;
+    if (!parseOptions(argc, argv, options))
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
+    host::setEpoch(options.epoch);
+    host::setWifiConnectDelayMs(options.wifiDelayMs);
+    if (options.rtc)
+    {
+        host::setRtc(true, true, options.rtcOffsetMs);
+    }
+    if (options.portal)
+    {
+        host::setWifiSaved(false);
+    }
+    host::setSerialMuted(!options.verbose);
+    #ifdef RTOS_TASKS
+    if (options.threads)
+    {
+        host::setRealtime(true);
+        host::setThreaded(true);
+    }
+    #else
+    if (options.threads)
+    {
+        fprintf(stderr, "--threads needs RTOS_TASKS in config.h\n");
+        return 1;
+    }
+    #endif
+
+    // Taken before setup(), which may already start the render task
+    const host::LedStats ledBefore = host::ledStats();
+    uint64_t simStart = host::nowMicros();
+    uint64_t cpuStart = cpuNanos();
+    setup();
+    const double setupSimMs = (host::nowMicros() - simStart) / 1000.0;
+    const double setupCpuMs = (cpuNanos() - cpuStart) / 1e6;
+
+    const uint64_t runStart = host::nowMicros();
+    const uint64_t runEnd = runStart + (uint64_t)options.seconds * 1000000;
+
+    printf("setup(): %.1f ms simulated, %.3f ms host cpu\n", setupSimMs, setupCpuMs);
+    #ifdef RTOS_TASKS
+    if (options.threads)
+    {
+        if (!tasksRunning)
+        {
+            fprintf(stderr, "Tasks did not start\n");
+            return 1;
+        }
+        while (host::nowMicros() < runEnd)
+        {
+            serviceScenario(options, host::nowMicros() - runStart);
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        host::stopTasks();
+        printf("First time frame: %.1f ms after boot\n", wordClock.getFirstFrameMicros() / 1000.0);
+        printf("Tasks: %lu s real time\n", options.seconds);
+        reportJitter("  render task wake-up jitter", renderJitter);
+        reportJitter("  network task pass jitter", networkJitter);
+    }
+    else
+    #endif
+    {
+        std::vector<float> simSamples;
+        std::vector<float> cpuSamples;
+        while (host::nowMicros() < runEnd)
+        {
+            serviceScenario(options, host::nowMicros() - runStart);
+            simStart = host::nowMicros();
+            cpuStart = cpuNanos();
+            loop();
+            cpuSamples.push_back((cpuNanos() - cpuStart) / 1000.0f);
+            simSamples.push_back((float)(host::nowMicros() - simStart));
+            host::advanceMicros(options.idleStepUs);
+        }
+        printf("First time frame: %.1f ms after boot\n", wordClock.getFirstFrameMicros() / 1000.0);
+        printf("loop(): %zu iterations over %lu s simulated\n\n", simSamples.size(), options.seconds);
+        report("loop() latency, simulated clock [us] (includes delay() and LED wire time)", simSamples);
+        report("loop() latency, host cpu [us]", cpuSamples);
+    }
+    reportJitter("Light commands to the renderer", commandLatency);
+
+    const host::LedStats& led = host::ledStats();
+    const uint32_t shows = led.shows - ledBefore.shows;
+    const uint32_t transfers = led.asyncTransfers - ledBefore.asyncTransfers;
+
+    printf("\nLED frames: %u blocking show() (%.1f ms CPU held), "
+           "%u async (%.1f ms on the wire alongside the CPU)\n",
+           shows, (led.busyMicros - ledBefore.busyMicros) / 1000.0,
+           transfers, (led.asyncMicros - ledBefore.asyncMicros) / 1000.0);
+    printf("LED power: %u mA now, %u mA peak, %u mA average, %u frames limited to %u mA\n",
+           wordClock.getCurrentMa(), wordClock.getPeakMa(), wordClock.getAverageMa(),
+           wordClock.getFramesLimited(), (unsigned)LED_POWER_BUDGET_MA);
+    printf("Animation: %.1f fps achieved, %u us frame budget, %u frames dropped\n",
+           wordClock.getFps(), wordClock.getFrameBudgetUs(), wordClock.getFramesDropped());
+    const host::MqttStats& mqtt = host::mqttStats();
+    printf("MQTT: %u connect attempts, %u published, %u delivered\n",
+           mqtt.connectAttempts, mqtt.published, mqtt.delivered);
+    printf("Config: %u flash writes, %u skipped as unchanged\n",
+           networkConnector.getConfigWrites(), networkConnector.getConfigWritesSkipped());
+    const SntpClock& sntp = networkConnector.getSntp();
+    printf("SNTP: %u samples, offset %ld us, delay %ld us, drift %ld ppb, poll %u s, last step %lld ms, "
+           "%u DNS lookups\n",
+           sntp.getSamples(), (long)sntp.getOffsetUs(), (long)sntp.getDelayUs(),
+           (long)sntp.getDriftPpb(), sntp.getPollInterval(), (long long)(sntp.getLastStepUs() / 1000),
+           host::dnsLookups());
+    static const char* const sources[] = { "none", "cache", "RTC", "SNTP" };
+    printf("Time: %s", sources[networkConnector.getTimeSource()]);
+    if (UINT32_MAX != networkConnector.getTimeErrorMs())
+    {
+        printf(", error within %u ms", networkConnector.getTimeErrorMs());
+    }
+    const RtcClock& rtc = networkConnector.getRtc();
+    printf("; RTC %s, %u reads, %u writes\n",
+           rtc.isPresent() ? "fitted" : "absent", rtc.getReads(), rtc.getWrites());
+    if (options.portal)
+    {
+        const host::PortalStats& portal = host::portalStats();
+        printf("Portal: %u requests, %u gzip'd, %u bytes in %u chunks\n",
+               portal.requests, portal.gzipResponses, portal.bytes, portal.chunks);
+    }
+    #ifdef PERF_PROBES
+    StdoutPrint out;
+    out.println();
+    perfSnapshot();
+    perfDump(out);
+    #endif
+    return 0;
+}
@@ -0,0 +1,184 @@
+/*
+  ANAVI Word Clock - ConfigStore checks for the host build
+
+  Runs the persistence layer against the in-memory NVS and SPIFFS
+  stand-ins: identical saves are skipped, save requests are debounced,
+  the JSON export is atomic, and recover() handles a reset at either
+  step of the export's remove-and-rename.
+*/
+
+#include <Arduino.h>
+#include <Preferences.h>
+#include <SPIFFS.h>
+#include "HostSim.h"
+#include "config.h"
+#include "config_store.h"
+
+#include <climits>
+#include <cstdio>
+#include <string>
+
+namespace {
+
+int failures = 0;
+
+#define CHECK(condition) check((condition), #condition, __LINE__)
+
+void check(bool ok, const char* what, int line)
+{
+    if (!ok)
+    {
+        printf("  FAILED line %d: %s\n", line, what);
+        failures++;
+    }
+}
+
+ConfigRecord makeRecord(const char* server)
+{
+    ConfigRecord record = {};
+    strcpy(record.mqtt_server, server);
+    strcpy(record.mqtt_port, "1883");
+    strcpy(record.timezone, "+2");
+    record.temp_celsius = 1;
+    return record;
+}
+
+void clearNvs()
+{
+    Preferences prefs;
+    prefs.begin(CONFIG_NVS_NAMESPACE, false);
+    prefs.clear();
+    prefs.end();
+}
+
+void writeFile(const char* path, const char* text)
+{
+    File file = SPIFFS.open(path, "w");
+    file.print(text);
+    file.close();
+}
+
+std::string readFile(const char* path)
+{
+    std::string text;
+    File file = SPIFFS.open(path, "r");
+    while (file && file.available())
+    {
+        text += (char)file.read();
+    }
+    return text;
+}
+
+void testSkipIdentical()
+{
+    printf("save skips identical records\n");
+    clearNvs();
+    ConfigStore store("/skip.json", "/skip.json.tmp");
+    ConfigRecord record = makeRecord("broker.local");
+    CHECK(store.save(record));
+    CHECK(1 == store.getWrites());
+    ConfigRecord same = makeRecord("broker.local");
+    CHECK(!store.save(same));
+    CHECK(1 == store.getWrites());
+    CHECK(1 == store.getSkipped());
+    ConfigRecord changed = makeRecord("other.local");
+    CHECK(store.save(changed));
+    CHECK(2 == store.getWrites());
+
+    // A fresh store knows what is stored from load(), and skips too
+    ConfigStore reloaded("/skip.json", "/skip.json.tmp");
+    ConfigRecord loaded;
+    CHECK(reloaded.load(loaded));
+    CHECK(0 == strcmp(loaded.mqtt_server, "other.local"));
+    CHECK(!reloaded.save(loaded));
+    CHECK(1 == reloaded.getSkipped());
+}
+
+void testRejectCorrupt()
+{
+    printf("load rejects a corrupt record\n");
+    clearNvs();
+    ConfigStore store("/crc.json", "/crc.json.tmp");
+    ConfigRecord record = makeRecord("broker.local");
+    CHECK(store.save(record));
+    record.mqtt_server[0] ^= 1;
+    Preferences prefs;
+    prefs.begin(CONFIG_NVS_NAMESPACE, false);
+    prefs.putBytes(CONFIG_NVS_KEY, &record, sizeof(record));
+    prefs.end();
+    ConfigRecord loaded;
+    CHECK(!store.load(loaded));
+}
+
+void testDebounce()
+{
+    printf("save requests are debounced\n");
+    ConfigStore store("/debounce.json", "/debounce.json.tmp");
+    CHECK(!store.isSaveDue(0));
+    store.requestSave(1000);
+    CHECK(!store.isSaveDue(1000 + CONFIG_SAVE_DELAY_MS - 1));
+    // A second request within the delay moves the write out
+    store.requestSave(1500);
+    CHECK(!store.isSaveDue(1000 + CONFIG_SAVE_DELAY_MS));
+    CHECK(store.isSaveDue(1500 + CONFIG_SAVE_DELAY_MS));
+    ConfigRecord record = makeRecord("broker.local");
+    store.save(record);
+    CHECK(!store.isSaveDue(1500 + CONFIG_SAVE_DELAY_MS));
+    // Due times survive millis() wrapping
+    const unsigned long late = ULONG_MAX - 100;
+    store.requestSave(late);
+    CHECK(!store.isSaveDue(late + 50));
+    CHECK(store.isSaveDue(late + CONFIG_SAVE_DELAY_MS));
+}
+
+void testExport()
+{
+    printf("export replaces the file and leaves no temp file\n");
+    ConfigStore store("/export.json", "/export.json.tmp");
+    writeFile("/export.json", "{\"old\":1}");
+    StaticJsonDocument<JSON_SMALL_SIZE> json;
+    json["mqtt_server"] = "broker.local";
+    CHECK(store.exportJson(json));
+    CHECK(readFile("/export.json") == "{\"mqtt_server\":\"broker.local\"}");
+    CHECK(!SPIFFS.exists("/export.json.tmp"));
+    CHECK(0 == store.getWrites());
+}
+
+void testRecover()
+{
+    printf("recover() after a reset during the export\n");
+    ConfigStore store("/recover.json", "/recover.json.tmp");
+
+    // Reset while the new file was written: the old one stands
+    writeFile("/recover.json", "old");
+    writeFile("/recover.json.tmp", "partial");
+    store.recover();
+    CHECK(readFile("/recover.json") == "old");
+    CHECK(!SPIFFS.exists("/recover.json.tmp"));
+
+    // Reset between removing the old file and the rename: finish it
+    SPIFFS.remove("/recover.json");
+    writeFile("/recover.json.tmp", "new");
+    store.recover();
+    CHECK(readFile("/recover.json") == "new");
+    CHECK(!SPIFFS.exists("/recover.json.tmp"));
+
+    // Nothing interrupted: nothing changes
+    store.recover();
+    CHECK(readFile("/recover.json") == "new");
+}
+
+} // namespace
+
+int main()
+{
+    host::setSerialMuted(true);
+    CHECK(SPIFFS.begin(false));
+    testSkipIdentical();
+    testRejectCorrupt();
+    testDebounce();
+    testExport();
+    testRecover();
+    printf(failures ? "%d checks failed\n" : "all checks passed\n", failures);
+    return failures ? 1 : 0;
+}
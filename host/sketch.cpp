@@ -0,0 +1,7 @@
+/*
+  ANAVI Word Clock - Host build wrapper for the sketch
+  The .ino is plain C++ once Arduino.h is available
+*/
+
+#include <Arduino.h>
+#include "anavi-word-clock-firmware.ino"
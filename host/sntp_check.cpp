@@ -0,0 +1,141 @@
+/*
+  ANAVI Word Clock - SntpClock check against local SNTP servers
+
+  Runs the firmware SNTP engine in real time against servers on this
+  workstation (see sntp_server) and reports, once a second, what it
+  measured and how far its clock is from CLOCK_REALTIME. --drift-ppm
+  makes the local oscillator run fast or slow to exercise the drift
+  estimate; servers started with --offset-ms shift the expected error.
+*/
+
+#include <Arduino.h>
+#include "HostSim.h"
+#include "sntp.h"
+
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <vector>
+
+namespace {
+
+struct Options {
+    unsigned long seconds = 120;
+    unsigned long pollMin = 8;
+    unsigned long pollMax = 64;
+    double driftPpm = 0;
+    std::vector<const char*> servers;
+};
+
+int64_t realtimeMicros()
+{
+    timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+void usage(const char* argv0)
+{
+    fprintf(stderr,
+            "Usage: %s --server HOST:PORT [--server HOST:PORT]... [--seconds N]\n"
+            "       [--poll-min SECONDS] [--poll-max SECONDS] [--drift-ppm X]\n",
+            argv0);
+}
+
+bool parseOptions(int argc, char** argv, Options& options)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        const bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "--server") == 0 && hasValue)
+        {
+            options.servers.push_back(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--seconds") == 0 && hasValue)
+        {
+            options.seconds = strtoul(argv[++i], nullptr, 10);
+        }
+        else if (strcmp(argv[i], "--poll-min") == 0 && hasValue)
+        {
+            options.pollMin = strtoul(argv[++i], nullptr, 10);
+        }
+        else if (strcmp(argv[i], "--poll-max") == 0 && hasValue)
+        {
+            options.pollMax = strtoul(argv[++i], nullptr, 10);
+        }
+        else if (strcmp(argv[i], "--drift-ppm") == 0 && hasValue)
+        {
+            options.driftPpm = strtod(argv[++i], nullptr);
+        }
+        else
+        {
+            return false;
+        }
+    }
+    return !options.servers.empty() && options.servers.size() <= SNTP_MAX_SERVERS;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options options;
+    if (!parseOptions(argc, argv, options))
+    {
+        usage(argv[0]);
+        return 2;
+    }
+
+    // The network is up from the start, only real time passes
+    host::setClockDriftPpm(options.driftPpm);
+    host::setWifiConnectDelayMs(0);
+    WiFi.begin();
+
+    SntpClock sntp;
+    sntp.setServers(options.servers.data(), (uint8_t)options.servers.size());
+    sntp.setPollRange(options.pollMin, options.pollMax);
+    sntp.begin();
+
+    printf("%6s %5s %10s %8s %9s %5s %10s  %s\n",
+           "time", "sync", "offset_us", "delay_us", "drift_ppb", "poll", "error_us", "server");
+    const uint64_t start = micros();
+    uint64_t nextReport = start + 1000000;
+    uint32_t seenSamples = 0;
+    int64_t worstError = 0;
+    for (;;)
+    {
+        sntp.service();
+        const uint64_t now = micros();
+        if (now >= nextReport)
+        {
+            const int64_t error = sntp.isSynchronized() ? (int64_t)sntp.nowUs() - realtimeMicros() : 0;
+            // Only the span after the first slewed sample says how good the
+            // discipline is, the step before it starts from nothing
+            if (sntp.getSamples() > 1 && llabs(error) > llabs(worstError))
+            {
+                worstError = error;
+            }
+            if (sntp.getSamples() != seenSamples || (now - start) / 1000000 % 10 == 0)
+            {
+                printf("%6lu %5s %10ld %8ld %9ld %5u %10lld  %s\n",
+                       (unsigned long)((now - start) / 1000000), sntp.isSynchronized() ? "yes" : "no",
+                       (long)sntp.getOffsetUs(), (long)sntp.getDelayUs(), (long)sntp.getDriftPpb(),
+                       sntp.getPollInterval(), (long long)error,
+                       sntp.getSamples() ? sntp.getServerName() : "-");
+                fflush(stdout);
+                seenSamples = sntp.getSamples();
+            }
+            nextReport += 1000000;
+            if (now - start >= (uint64_t)options.seconds * 1000000)
+            {
+                break;
+            }
+        }
+        // Real time only, delay() would skip simulated time instead
+        const timespec pause = { 0, 1000000 };
+        nanosleep(&pause, nullptr);
+    }
+    printf("Samples: %u, worst error after the first slew: %lld us\n",
+           sntp.getSamples(), (long long)worstError);
+    return sntp.isSynchronized() ? 0 : 1;
+}
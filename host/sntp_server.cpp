@@ -0,0 +1,188 @@
+/*
+  ANAVI Word Clock - local SNTP stand-in server for the host build
+
+  Answers SNTP requests on a UDP port with CLOCK_REALTIME, optionally off
+  by a fixed offset and behind a simulated network path. Several instances on different ports give
+  sntp_check servers of different quality to choose from.
+*/
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <deque>
+#include <random>
+
+namespace {
+
+const uint64_t NTP_UNIX_DELTA = 2208988800ULL;
+
+struct Options {
+    uint16_t port = 12300;
+    long offsetMs = 0;
+    unsigned long delayMs = 0;   // round trip added by the simulated path
+    unsigned long jitterMs = 0;  // random extra on the way back only
+    int stratum = 2;
+};
+
+struct Reply {
+    uint64_t sendAt;  // CLOCK_MONOTONIC us
+    sockaddr_in to;
+    uint8_t packet[48];
+};
+
+uint64_t clockMicros(clockid_t id)
+{
+    timespec ts;
+    clock_gettime(id, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+void writeTimestamp(uint8_t* out, uint64_t unixUs)
+{
+    const uint32_t seconds = (uint32_t)(unixUs / 1000000 + NTP_UNIX_DELTA);
+    const uint32_t fraction = (uint32_t)(((unixUs % 1000000) << 32) / 1000000);
+    for (int i = 0; i < 4; i++)
+    {
+        out[i] = (uint8_t)(seconds >> (24 - 8 * i));
+        out[4 + i] = (uint8_t)(fraction >> (24 - 8 * i));
+    }
+}
+
+void usage(const char* argv0)
+{
+    fprintf(stderr,
+            "Usage: %s [--port N] [--offset-ms N] [--delay-ms N]\n"
+            "       [--jitter-ms N] [--stratum N]\n",
+            argv0);
+}
+
+bool parseOptions(int argc, char** argv, Options& options)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        const bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "--port") == 0 && hasValue)
+        {
+            options.port = (uint16_t)strtoul(argv[++i], nullptr, 10);
+        }
+        else if (strcmp(argv[i], "--offset-ms") == 0 && hasValue)
+        {
+            options.offsetMs = strtol(argv[++i], nullptr, 10);
+        }
+        else if (strcmp(argv[i], "--delay-ms") == 0 && hasValue)
+        {
+            options.delayMs = strtoul(argv[++i], nullptr, 10);
+        }
+        else if (strcmp(argv[i], "--jitter-ms") == 0 && hasValue)
+        {
+            options.jitterMs = strtoul(argv[++i], nullptr, 10);
+        }
+        else if (strcmp(argv[i], "--stratum") == 0 && hasValue)
+        {
+            options.stratum = atoi(argv[++i]);
+        }
+        else
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options options;
+    if (!parseOptions(argc, argv, options))
+    {
+        usage(argv[0]);
+        return 2;
+    }
+
+    const int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    sockaddr_in local = {};
+    local.sin_family = AF_INET;
+    local.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    local.sin_port = htons(options.port);
+    if (fd < 0 || bind(fd, (sockaddr*)&local, sizeof(local)) < 0)
+    {
+        perror("bind");
+        return 1;
+    }
+    printf("SNTP stand-in on 127.0.0.1:%u, offset %ld ms, delay %lu ms, jitter %lu ms\n",
+           options.port, options.offsetMs, options.delayMs, options.jitterMs);
+    fflush(stdout);
+
+    // Served time follows CLOCK_REALTIME, stamped on the monotonic clock
+    // so the simulated path delays can be added to it
+    const int64_t realFromMono = (int64_t)clockMicros(CLOCK_REALTIME) - (int64_t)clockMicros(CLOCK_MONOTONIC);
+    auto servedMicros = [&](uint64_t mono) {
+        return (uint64_t)((int64_t)mono + realFromMono + options.offsetMs * 1000);
+    };
+
+    std::mt19937 rng(std::random_device{}());
+    std::deque<Reply> replies;
+    for (;;)
+    {
+        int timeoutMs = -1;
+        if (!replies.empty())
+        {
+            const uint64_t now = clockMicros(CLOCK_MONOTONIC);
+            timeoutMs = replies.front().sendAt > now ? (int)((replies.front().sendAt - now) / 1000) : 0;
+        }
+        pollfd waiting = { fd, POLLIN, 0 };
+        poll(&waiting, 1, timeoutMs);
+
+        uint8_t request[512];
+        sockaddr_in remote = {};
+        socklen_t remoteLength = sizeof(remote);
+        const ssize_t length = recvfrom(fd, request, sizeof(request), MSG_DONTWAIT,
+                                        (sockaddr*)&remote, &remoteLength);
+        if (length >= 48 && 3 == (request[0] & 0x07))
+        {
+            const uint64_t received = clockMicros(CLOCK_MONOTONIC);
+            const uint64_t back = options.delayMs * 500ULL +
+                (options.jitterMs ? rng() % (options.jitterMs * 1000) : 0);
+            Reply reply;
+            reply.to = remote;
+            memset(reply.packet, 0, sizeof(reply.packet));
+            reply.packet[0] = (request[0] & 0x38) | 0x04;  // LI 0, the client's version, mode 4
+            reply.packet[1] = (uint8_t)options.stratum;
+            reply.packet[2] = request[2];
+            reply.packet[3] = (uint8_t)-20;  // about a microsecond
+            memcpy(reply.packet + 12, "LOCL", 4);
+            memcpy(reply.packet + 24, request + 40, 8);
+            // The request reaches the server half a round trip after it left
+            const uint64_t served = servedMicros(received + options.delayMs * 500ULL);
+            writeTimestamp(reply.packet + 16, served);
+            writeTimestamp(reply.packet + 32, served);
+            writeTimestamp(reply.packet + 40, served);
+            reply.sendAt = received + options.delayMs * 500ULL + back;
+            // Keep the queue ordered by release time
+            auto it = replies.end();
+            while (it != replies.begin() && (it - 1)->sendAt > reply.sendAt)
+            {
+                --it;
+            }
+            replies.insert(it, reply);
+        }
+
+        const uint64_t now = clockMicros(CLOCK_MONOTONIC);
+        while (!replies.empty() && replies.front().sendAt <= now)
+        {
+            const Reply& reply = replies.front();
+            sendto(fd, reply.packet, sizeof(reply.packet), 0, (const sockaddr*)&reply.to, sizeof(reply.to));
+            replies.pop_front();
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,26 @@
+/*
+  ANAVI Word Clock - Host build stand-in for Adafruit_GFX
+*/
+
+#ifndef HOST_ADAFRUIT_GFX_H
+#define HOST_ADAFRUIT_GFX_H
+
+#include <Arduino.h>
+
+class Adafruit_GFX {
+public:
+    Adafruit_GFX(int16_t w, int16_t h) : _width(w), _height(h) {}
+    virtual ~Adafruit_GFX() {}
+
+    virtual void drawPixel(int16_t x, int16_t y, uint16_t color) = 0;
+    virtual void fillScreen(uint16_t color);
+
+    int16_t width() const { return _width; }
+    int16_t height() const { return _height; }
+
+protected:
+    int16_t _width;
+    int16_t _height;
+};
+
+#endif // HOST_ADAFRUIT_GFX_H
@@ -0,0 +1,154 @@
+/*
+  ANAVI Word Clock - Host build stand-in for Adafruit_NeoPixel and
+  Adafruit_NeoMatrix
+*/
+
+#include "Adafruit_NeoMatrix.h"
+#include "HostSim.h"
+
+void Adafruit_GFX::fillScreen(uint16_t color)
+{
+    for (int16_t y = 0; y < _height; y++)
+    {
+        for (int16_t x = 0; x < _width; x++)
+        {
+            drawPixel(x, y, color);
+        }
+    }
+}
+
+Adafruit_NeoPixel::Adafruit_NeoPixel(uint16_t n, int16_t pin, neoPixelType type)
+    : numLEDs(n)
+    , brightness(0)
+    , pixels(new uint8_t[n * 3]())
+{
+    (void)pin;
+    (void)type;
+}
+
+Adafruit_NeoPixel::~Adafruit_NeoPixel()
+{
+    delete[] pixels;
+}
+
+void Adafruit_NeoPixel::show()
+{
+    // The real driver bit-bangs with interrupts off, so the CPU is busy
+    // for the whole transfer
+    const uint32_t busy = wireMicros(numLEDs);
+    host::advanceMicros(busy);
+    host::recordShow(busy);
+}
+
+void Adafruit_NeoPixel::clear()
+{
+    memset(pixels, 0, numLEDs * 3);
+}
+
+void Adafruit_NeoPixel::setPixelColor(uint16_t n, uint8_t r, uint8_t g, uint8_t b)
+{
+    if (n >= numLEDs)
+    {
+        return;
+    }
+    if (brightness)
+    {
+        r = (r * brightness) >> 8;
+        g = (g * brightness) >> 8;
+        b = (b * brightness) >> 8;
+    }
+    uint8_t* p = &pixels[n * 3];
+    p[0] = g;
+    p[1] = r;
+    p[2] = b;
+}
+
+void Adafruit_NeoPixel::setPixelColor(uint16_t n, uint32_t c)
+{
+    setPixelColor(n, (uint8_t)(c >> 16), (uint8_t)(c >> 8), (uint8_t)c);
+}
+
+uint32_t Adafruit_NeoPixel::getPixelColor(uint16_t n) const
+{
+    if (n >= numLEDs)
+    {
+        return 0;
+    }
+    const uint8_t* p = &pixels[n * 3];
+    uint8_t r = p[1];
+    uint8_t g = p[0];
+    uint8_t b = p[2];
+    if (brightness)
+    {
+        r = (r << 8) / brightness;
+        g = (g << 8) / brightness;
+        b = (b << 8) / brightness;
+    }
+    return Color(r, g, b);
+}
+
+void Adafruit_NeoPixel::setBrightness(uint8_t b)
+{
+    // Same lossy in-place rescale as the real library
+    uint8_t newBrightness = b + 1;
+    if (newBrightness != brightness)
+    {
+        uint8_t oldBrightness = brightness - 1;
+        uint16_t scale;
+        if (oldBrightness == 0)
+        {
+            scale = 0;
+        }
+        else if (b == 255)
+        {
+            scale = 65535 / oldBrightness;
+        }
+        else
+        {
+            scale = (((uint16_t)newBrightness << 8) - 1) / oldBrightness;
+        }
+        for (uint16_t i = 0; i < numLEDs * 3; i++)
+        {
+            pixels[i] = (pixels[i] * scale) >> 8;
+        }
+        brightness = newBrightness;
+    }
+}
+
+Adafruit_NeoMatrix::Adafruit_NeoMatrix(int w, int h, uint8_t pin,
+                                       uint8_t matrixType, neoPixelType ledType)
+    : Adafruit_GFX(w, h)
+    , Adafruit_NeoPixel(w * h, pin, ledType)
+    , type(matrixType)
+{
+}
+
+void Adafruit_NeoMatrix::drawPixel(int16_t x, int16_t y, uint16_t color)
+{
+    if (x < 0 || y < 0 || x >= _width || y >= _height)
+    {
+        return;
+    }
+    int16_t minor = x;
+    if ((type & NEO_MATRIX_SEQUENCE) == NEO_MATRIX_ZIGZAG && (y & 1))
+    {
+        minor = _width - 1 - x;
+    }
+    setPixelColor(y * _width + minor, expandColor(color));
+}
+
+void Adafruit_NeoMatrix::fillScreen(uint16_t color)
+{
+    const uint32_t c = expandColor(color);
+    for (uint16_t i = 0; i < numLEDs; i++)
+    {
+        setPixelColor(i, c);
+    }
+}
+
+uint32_t Adafruit_NeoMatrix::expandColor(uint16_t color)
+{
+    return ((uint32_t)(color & 0xF800) << 8) |
+           ((uint32_t)(color & 0x07E0) << 5) |
+           ((uint32_t)(color & 0x001F) << 3);
+}
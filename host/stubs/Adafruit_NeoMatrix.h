@@ -0,0 +1,43 @@
+/*
+  ANAVI Word Clock - Host build stand-in for Adafruit_NeoMatrix
+*/
+
+#ifndef HOST_ADAFRUIT_NEOMATRIX_H
+#define HOST_ADAFRUIT_NEOMATRIX_H
+
+#include <Adafruit_GFX.h>
+#include <Adafruit_NeoPixel.h>
+
+#define NEO_MATRIX_TOP         0x00
+#define NEO_MATRIX_BOTTOM      0x01
+#define NEO_MATRIX_LEFT        0x00
+#define NEO_MATRIX_RIGHT       0x02
+#define NEO_MATRIX_CORNER      0x03
+#define NEO_MATRIX_ROWS        0x00
+#define NEO_MATRIX_COLUMNS     0x04
+#define NEO_MATRIX_AXIS        0x04
+#define NEO_MATRIX_PROGRESSIVE 0x00
+#define NEO_MATRIX_ZIGZAG      0x08
+#define NEO_MATRIX_SEQUENCE    0x08
+
+class Adafruit_NeoMatrix : public Adafruit_GFX, public Adafruit_NeoPixel {
+public:
+    Adafruit_NeoMatrix(int w, int h, uint8_t pin = 6,
+                       uint8_t matrixType = NEO_MATRIX_TOP + NEO_MATRIX_LEFT + NEO_MATRIX_ROWS,
+                       neoPixelType ledType = NEO_GRB + NEO_KHZ800);
+
+    void drawPixel(int16_t x, int16_t y, uint16_t color) override;
+    void fillScreen(uint16_t color) override;
+
+    // 5-6-5 packed color, as returned by the real library
+    static uint16_t Color(uint8_t r, uint8_t g, uint8_t b)
+    {
+        return ((uint16_t)(r & 0xF8) << 8) | ((uint16_t)(g & 0xFC) << 3) | (b >> 3);
+    }
+
+private:
+    uint8_t type;
+    static uint32_t expandColor(uint16_t color);
+};
+
+#endif // HOST_ADAFRUIT_NEOMATRIX_H
@@ -0,0 +1,50 @@
+/*
+  ANAVI Word Clock - Host build stand-in for Adafruit_NeoPixel
+  Keeps the pixel buffer in memory and models the WS2812B wire time
+*/
+
+#ifndef HOST_ADAFRUIT_NEOPIXEL_H
+#define HOST_ADAFRUIT_NEOPIXEL_H
+
+#include <Arduino.h>
+
+#define NEO_RGB ((0 << 6) | (0 << 4) | (1 << 2) | (2))
+#define NEO_GRB ((1 << 6) | (1 << 4) | (0 << 2) | (2))
+#define NEO_KHZ800 0x0000
+#define NEO_KHZ400 0x0100
+
+typedef uint16_t neoPixelType;
+
+class Adafruit_NeoPixel {
+public:
+    Adafruit_NeoPixel(uint16_t n, int16_t pin = 6, neoPixelType type = NEO_GRB + NEO_KHZ800);
+    virtual ~Adafruit_NeoPixel();
+
+    void begin() {}
+    void show();
+    bool canShow() const { return true; }
+    void clear();
+
+    void setPixelColor(uint16_t n, uint8_t r, uint8_t g, uint8_t b);
+    void setPixelColor(uint16_t n, uint32_t c);
+    uint32_t getPixelColor(uint16_t n) const;
+    void setBrightness(uint8_t b);
+    uint8_t getBrightness() const { return brightness - 1; }
+    uint8_t* getPixels() const { return pixels; }
+    uint16_t numPixels() const { return numLEDs; }
+
+    static uint32_t Color(uint8_t r, uint8_t g, uint8_t b)
+    {
+        return ((uint32_t)r << 16) | ((uint32_t)g << 8) | b;
+    }
+
+    // WS2812B at 800 kHz: 30 us per pixel plus the 50 us latch
+    static uint32_t wireMicros(uint16_t n) { return (uint32_t)n * 30 + 50; }
+
+protected:
+    uint16_t numLEDs;
+    uint8_t brightness;
+    uint8_t* pixels;
+};
+
+#endif // HOST_ADAFRUIT_NEOPIXEL_H
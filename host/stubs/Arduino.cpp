@@ -0,0 +1,374 @@
+/*
+  ANAVI Word Clock - Host build stand-in for the Arduino core
+*/
+
+#include "Arduino.h"
+#include "HostSim.h"
+
+#include <chrono>
+#include <cstdarg>
+#include <random>
+#include <thread>
+#include <strings.h>
+
+namespace {
+
+const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+uint64_t skippedMicros = 0;
+double clockDriftPpm = 0;
+uint32_t epochBase = 1760000000;  // 2025-10-09 08:53:20 UTC
+bool serialMuted = false;
+bool realtime = false;
+
+// Inputs idle high, so the button reads as released
+struct PinLevels {
+    int level[64];
+    PinLevels() { for (int &l : level) l = HIGH; }
+} pins;
+
+uint64_t efuseMac = 0x0000A4CF12345678ULL;
+host::LedStats ledStats = { 0, 0, 0, 0 };
+std::mt19937 rng(42);
+
+} // namespace
+
+namespace host {
+
+uint64_t realMicros()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - startTime).count();
+}
+
+uint64_t nowMicros()
+{
+    const uint64_t real = realMicros();
+    return real + (int64_t)(real * clockDriftPpm / 1e6) + skippedMicros;
+}
+
+void setRealtime(bool on)
+{
+    realtime = on;
+}
+
+void setClockDriftPpm(double ppm)
+{
+    clockDriftPpm = ppm;
+}
+
+void advanceMicros(uint64_t us)
+{
+    skippedMicros += us;
+}
+
+void setEpoch(uint32_t epoch)
+{
+    epochBase = epoch;
+}
+
+uint32_t epoch()
+{
+    return epochBase;
+}
+
+void setSerialMuted(bool muted)
+{
+    serialMuted = muted;
+}
+
+void setPinLevel(uint8_t pin, int level)
+{
+    if (pin < 64)
+    {
+        pins.level[pin] = level;
+    }
+}
+
+void setEfuseMac(uint64_t mac)
+{
+    efuseMac = mac;
+}
+
+const LedStats& ledStats()
+{
+    return ::ledStats;
+}
+
+void recordShow(uint64_t busyMicros)
+{
+    ::ledStats.shows++;
+    ::ledStats.busyMicros += busyMicros;
+}
+
+void recordAsyncTransfer(uint64_t wireMicros)
+{
+    ::ledStats.asyncTransfers++;
+    ::ledStats.asyncMicros += wireMicros;
+}
+
+} // namespace host
+
+// Timing
+
+unsigned long millis()
+{
+    return (unsigned long)(host::nowMicros() / 1000);
+}
+
+unsigned long micros()
+{
+    return (unsigned long)host::nowMicros();
+}
+
+void delay(uint32_t ms)
+{
+    if (realtime)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+        return;
+    }
+    host::advanceMicros((uint64_t)ms * 1000);
+}
+
+void delayMicroseconds(uint32_t us)
+{
+    if (realtime)
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds(us));
+        return;
+    }
+    host::advanceMicros(us);
+}
+
+void yield()
+{
+}
+
+// GPIO
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+    (void)pin;
+    (void)mode;
+}
+
+void digitalWrite(uint8_t pin, uint8_t val)
+{
+    (void)pin;
+    (void)val;
+}
+
+int digitalRead(uint8_t pin)
+{
+    return (pin < 64) ? pins.level[pin] : LOW;
+}
+
+// Random numbers
+
+long random(long howbig)
+{
+    if (howbig <= 0)
+    {
+        return 0;
+    }
+    return (long)(rng() % (unsigned long)howbig);
+}
+
+long random(long howsmall, long howbig)
+{
+    if (howsmall >= howbig)
+    {
+        return howsmall;
+    }
+    return howsmall + random(howbig - howsmall);
+}
+
+void randomSeed(unsigned long seed)
+{
+    rng.seed(seed);
+}
+
+// Serial
+
+HardwareSerial Serial;
+
+size_t HardwareSerial::write(uint8_t c)
+{
+    if (!serialMuted)
+    {
+        fputc(c, stderr);
+    }
+    return 1;
+}
+
+size_t HardwareSerial::write(const uint8_t* buffer, size_t size)
+{
+    if (!serialMuted)
+    {
+        fwrite(buffer, 1, size, stderr);
+    }
+    return size;
+}
+
+// ESP
+
+EspClass ESP;
+
+uint64_t EspClass::getEfuseMac()
+{
+    return efuseMac;
+}
+
+uint32_t EspClass::getCycleCount()
+{
+    // 160 MHz core clock, like the ESP32-C3
+    const uint64_t nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - startTime).count();
+    return (uint32_t)(nanos * 160 / 1000);
+}
+
+void EspClass::restart()
+{
+    Serial.println("[host] ESP.restart() requested, exiting");
+    exit(0);
+}
+
+// Print
+
+size_t Print::write(const uint8_t* buffer, size_t size)
+{
+    size_t n = 0;
+    while (size--)
+    {
+        n += write(*buffer++);
+    }
+    return n;
+}
+
+size_t Print::print(const char* str)
+{
+    return write(str);
+}
+
+size_t Print::print(char c)
+{
+    return write((uint8_t)c);
+}
+
+size_t Print::print(const String& s)
+{
+    return write(s.c_str(), s.length());
+}
+
+size_t Print::print(long long n, int base)
+{
+    char buf[72];
+    if (base == 10)
+    {
+        snprintf(buf, sizeof(buf), "%lld", n);
+        return write(buf);
+    }
+    return print((unsigned long long)n, base);
+}
+
+size_t Print::print(unsigned long long n, int base)
+{
+    char buf[72];
+    char* p = buf + sizeof(buf) - 1;
+    *p = '\0';
+    if (base < 2)
+    {
+        base = 10;
+    }
+    do
+    {
+        int digit = n % base;
+        *--p = (char)(digit < 10 ? '0' + digit : 'A' + digit - 10);
+        n /= base;
+    } while (n);
+    return write(p);
+}
+
+size_t Print::print(int n, int base) { return print((long long)n, base); }
+size_t Print::print(unsigned int n, int base) { return print((unsigned long long)n, base); }
+size_t Print::print(long n, int base) { return print((long long)n, base); }
+size_t Print::print(unsigned long n, int base) { return print((unsigned long long)n, base); }
+
+size_t Print::print(double n, int digits)
+{
+    char buf[64];
+    snprintf(buf, sizeof(buf), "%.*f", digits, n);
+    return write(buf);
+}
+
+size_t Print::print(const Printable& p)
+{
+    return p.printTo(*this);
+}
+
+size_t Print::println()
+{
+    return write("\r\n");
+}
+
+size_t Print::printf(const char* format, ...)
+{
+    char buf[256];
+    va_list args;
+    va_start(args, format);
+    int len = vsnprintf(buf, sizeof(buf), format, args);
+    va_end(args);
+    if (len < 0)
+    {
+        return 0;
+    }
+    return write(buf, std::min((size_t)len, sizeof(buf) - 1));
+}
+
+// String
+
+String::String(float value, unsigned int decimals)
+    : String((double)value, decimals)
+{
+}
+
+String::String(double value, unsigned int decimals)
+{
+    char buf[64];
+    snprintf(buf, sizeof(buf), "%.*f", (int)decimals, value);
+    str = buf;
+}
+
+String String::substring(unsigned int from) const
+{
+    return substring(from, str.size());
+}
+
+String String::substring(unsigned int from, unsigned int to) const
+{
+    if (from > to)
+    {
+        std::swap(from, to);
+    }
+    if (from >= str.size())
+    {
+        return String();
+    }
+    return String(str.substr(from, to - from));
+}
+
+bool String::equalsIgnoreCase(const String& other) const
+{
+    return str.size() == other.str.size() && strcasecmp(str.c_str(), other.str.c_str()) == 0;
+}
+
+void String::toCharArray(char* buf, unsigned int bufsize) const
+{
+    if (!buf || bufsize == 0)
+    {
+        return;
+    }
+    size_t len = std::min((size_t)bufsize - 1, str.size());
+    memcpy(buf, str.data(), len);
+    buf[len] = '\0';
+}
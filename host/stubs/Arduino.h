@@ -0,0 +1,103 @@
+/*
+  ANAVI Word Clock - Host build stand-in for Arduino.h
+  Core types, GPIO and timing for running the sketch on Linux.
+  delay() advances a simulated clock instead of sleeping unless real time
+  is asked for, see HostSim.h
+*/
+
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <cstdint>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#include <cmath>
+#include <memory>
+#include <algorithm>
+
+#include "Print.h"
+#include "WString.h"
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define PROGMEM
+#define PGM_P const char*
+#define PSTR(s) (s)
+#define F(s) (s)
+#define pgm_read_byte(addr) (*(const uint8_t*)(addr))
+#define pgm_read_word(addr) (*(const uint16_t*)(addr))
+#define pgm_read_dword(addr) (*(const uint32_t*)(addr))
+#define strlen_P strlen
+#define memcpy_P memcpy
+
+#define HIGH 0x1
+#define LOW  0x0
+
+#define INPUT        0x01
+#define OUTPUT       0x03
+#define INPUT_PULLUP 0x05
+
+// Seeed XIAO ESP32C3 pin aliases
+#define D0  2
+#define D1  3
+#define D2  4
+#define D3  5
+#define D4  6
+#define D5  7
+#define D6  21
+#define D7  20
+#define D8  8
+#define D9  9
+#define D10 10
+
+#define bitRead(value, bit) (((value) >> (bit)) & 0x01)
+#define bitSet(value, bit) ((value) |= (1ULL << (bit)))
+#define bitClear(value, bit) ((value) &= ~(1ULL << (bit)))
+
+using std::min;
+using std::max;
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+// Timing
+unsigned long millis();
+unsigned long micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+void yield();
+
+// GPIO
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+
+// Random numbers
+long random(long howbig);
+long random(long howsmall, long howbig);
+void randomSeed(unsigned long seed);
+
+class HardwareSerial : public Print {
+public:
+    void begin(unsigned long baud) { (void)baud; }
+    operator bool() const { return true; }
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* buffer, size_t size) override;
+    using Print::write;
+};
+
+extern HardwareSerial Serial;
+
+class EspClass {
+public:
+    uint64_t getEfuseMac();
+    uint32_t getCycleCount();
+    uint32_t getFreeHeap() { return 200 * 1024; }
+    void restart();
+};
+
+extern EspClass ESP;
+
+#endif // HOST_ARDUINO_H
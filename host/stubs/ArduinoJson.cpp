@@ -0,0 +1,390 @@
+/*
+  ANAVI Word Clock - Host build stand-in for ArduinoJson
+*/
+
+#include "ArduinoJson.h"
+
+namespace {
+
+class StringPrint : public Print {
+public:
+    size_t write(uint8_t c) override { out += (char)c; return 1; }
+    using Print::write;
+    std::string out;
+};
+
+void printString(Print& out, const std::string& s)
+{
+    out.write('"');
+    for (char c : s)
+    {
+        switch (c)
+        {
+            case '"':  out.write("\\\""); break;
+            case '\\': out.write("\\\\"); break;
+            case '\n': out.write("\\n"); break;
+            case '\r': out.write("\\r"); break;
+            case '\t': out.write("\\t"); break;
+            default:   out.write((uint8_t)c); break;
+        }
+    }
+    out.write('"');
+}
+
+struct Parser {
+    const char* p;
+    const char* end;
+
+    void skipSpace()
+    {
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n'))
+        {
+            p++;
+        }
+    }
+
+    bool parseString(std::string& out)
+    {
+        if (p >= end || *p != '"')
+        {
+            return false;
+        }
+        p++;
+        while (p < end && *p != '"')
+        {
+            char c = *p++;
+            if (c == '\\' && p < end)
+            {
+                c = *p++;
+                switch (c)
+                {
+                    case 'n': c = '\n'; break;
+                    case 'r': c = '\r'; break;
+                    case 't': c = '\t'; break;
+                    default: break;
+                }
+            }
+            out += c;
+        }
+        if (p >= end)
+        {
+            return false;
+        }
+        p++;
+        return true;
+    }
+
+    bool parseValue(JsonValue& value)
+    {
+        skipSpace();
+        if (p >= end)
+        {
+            return false;
+        }
+        if (*p == '"')
+        {
+            value.type = JsonValue::Str;
+            return parseString(value.str);
+        }
+        if (end - p >= 4 && strncmp(p, "true", 4) == 0)
+        {
+            value.type = JsonValue::Bool;
+            value.flag = true;
+            p += 4;
+            return true;
+        }
+        if (end - p >= 5 && strncmp(p, "false", 5) == 0)
+        {
+            value.type = JsonValue::Bool;
+            value.flag = false;
+            p += 5;
+            return true;
+        }
+        if (end - p >= 4 && strncmp(p, "null", 4) == 0)
+        {
+            value.type = JsonValue::Null;
+            p += 4;
+            return true;
+        }
+        std::string number;
+        while (p < end && (isdigit((unsigned char)*p) || *p == '-' || *p == '+' ||
+                           *p == '.' || *p == 'e' || *p == 'E'))
+        {
+            number += *p++;
+        }
+        if (number.empty())
+        {
+            return false;
+        }
+        value.type = JsonValue::Num;
+        value.num = atof(number.c_str());
+        return true;
+    }
+
+    DeserializationError parse(JsonDocument& doc)
+    {
+        skipSpace();
+        if (p >= end)
+        {
+            return DeserializationError::EmptyInput;
+        }
+        if (*p++ != '{')
+        {
+            return DeserializationError::InvalidInput;
+        }
+        skipSpace();
+        if (p < end && *p == '}')
+        {
+            return DeserializationError::Ok;
+        }
+        while (p < end)
+        {
+            skipSpace();
+            std::string key;
+            if (!parseString(key))
+            {
+                return DeserializationError::InvalidInput;
+            }
+            skipSpace();
+            if (p >= end || *p++ != ':')
+            {
+                return DeserializationError::InvalidInput;
+            }
+            JsonValue value;
+            if (!parseValue(value))
+            {
+                return DeserializationError::InvalidInput;
+            }
+            doc.insert(key) = value;
+            skipSpace();
+            if (p >= end)
+            {
+                return DeserializationError::IncompleteInput;
+            }
+            if (*p == '}')
+            {
+                return DeserializationError::Ok;
+            }
+            if (*p++ != ',')
+            {
+                return DeserializationError::InvalidInput;
+            }
+        }
+        return DeserializationError::IncompleteInput;
+    }
+};
+
+} // namespace
+
+const JsonValue* JsonVariant::value() const
+{
+    return doc.find(key);
+}
+
+JsonValue& JsonVariant::slot()
+{
+    return doc.insert(key);
+}
+
+JsonVariant& JsonVariant::operator=(const char* s)
+{
+    JsonValue& v = slot();
+    if (s)
+    {
+        v.type = JsonValue::Str;
+        v.str = s;
+    }
+    else
+    {
+        v.type = JsonValue::Null;
+    }
+    return *this;
+}
+
+JsonVariant& JsonVariant::operator=(bool b)
+{
+    JsonValue& v = slot();
+    v.type = JsonValue::Bool;
+    v.flag = b;
+    return *this;
+}
+
+JsonVariant& JsonVariant::operator=(double n)
+{
+    JsonValue& v = slot();
+    v.type = JsonValue::Num;
+    v.num = n;
+    return *this;
+}
+
+template <>
+const char* JsonVariant::as<const char*>() const
+{
+    const JsonValue* v = value();
+    return (v && v->type == JsonValue::Str) ? v->str.c_str() : nullptr;
+}
+
+template <>
+String JsonVariant::as<String>() const
+{
+    const char* s = as<const char*>();
+    return String(s ? s : "null");
+}
+
+template <>
+double JsonVariant::as<double>() const
+{
+    const JsonValue* v = value();
+    if (!v)
+    {
+        return 0;
+    }
+    switch (v->type)
+    {
+        case JsonValue::Num:  return v->num;
+        case JsonValue::Bool: return v->flag ? 1 : 0;
+        case JsonValue::Str:  return atof(v->str.c_str());
+        default:              return 0;
+    }
+}
+
+template <> float JsonVariant::as<float>() const { return (float)as<double>(); }
+template <> int JsonVariant::as<int>() const { return (int)as<double>(); }
+template <> long JsonVariant::as<long>() const { return (long)as<double>(); }
+template <> unsigned int JsonVariant::as<unsigned int>() const { return (unsigned int)as<double>(); }
+template <> unsigned long JsonVariant::as<unsigned long>() const { return (unsigned long)as<double>(); }
+template <> uint8_t JsonVariant::as<uint8_t>() const { return (uint8_t)as<double>(); }
+
+template <>
+bool JsonVariant::as<bool>() const
+{
+    const JsonValue* v = value();
+    if (!v)
+    {
+        return false;
+    }
+    return v->type == JsonValue::Bool ? v->flag : as<double>() != 0;
+}
+
+const JsonValue* JsonDocument::find(const std::string& key) const
+{
+    for (const auto& member : members)
+    {
+        if (member.first == key)
+        {
+            return &member.second;
+        }
+    }
+    return nullptr;
+}
+
+JsonValue& JsonDocument::insert(const std::string& key)
+{
+    for (auto& member : members)
+    {
+        if (member.first == key)
+        {
+            return member.second;
+        }
+    }
+    members.emplace_back(key, JsonValue());
+    return members.back().second;
+}
+
+const char* DeserializationError::c_str() const
+{
+    switch (code)
+    {
+        case Ok:              return "Ok";
+        case EmptyInput:      return "EmptyInput";
+        case IncompleteInput: return "IncompleteInput";
+        case InvalidInput:    return "InvalidInput";
+        case NoMemory:        return "NoMemory";
+    }
+    return "???";
+}
+
+DeserializationError deserializeJson(JsonDocument& doc, const char* input)
+{
+    return deserializeJson(doc, input, input ? strlen(input) : 0);
+}
+
+DeserializationError deserializeJson(JsonDocument& doc, const char* input, size_t length)
+{
+    doc.clear();
+    if (!input)
+    {
+        return DeserializationError::EmptyInput;
+    }
+    Parser parser = { input, input + length };
+    return parser.parse(doc);
+}
+
+DeserializationError deserializeJson(JsonDocument& doc, const uint8_t* input, size_t length)
+{
+    return deserializeJson(doc, (const char*)input, length);
+}
+
+DeserializationError deserializeJson(JsonDocument& doc, const String& input)
+{
+    return deserializeJson(doc, input.c_str(), input.length());
+}
+
+size_t serializeJson(const JsonDocument& doc, Print& output)
+{
+    StringPrint out;
+    out.write('{');
+    bool first = true;
+    for (const auto& member : doc.entries())
+    {
+        if (!first)
+        {
+            out.write(',');
+        }
+        first = false;
+        printString(out, member.first);
+        out.write(':');
+        const JsonValue& v = member.second;
+        switch (v.type)
+        {
+            case JsonValue::Str:
+                printString(out, v.str);
+                break;
+            case JsonValue::Num:
+            {
+                char buf[32];
+                snprintf(buf, sizeof(buf), "%.9g", v.num);
+                out.write(buf);
+                break;
+            }
+            case JsonValue::Bool:
+                out.write(v.flag ? "true" : "false");
+                break;
+            case JsonValue::Null:
+                out.write("null");
+                break;
+        }
+    }
+    out.write('}');
+    return output.write((const uint8_t*)out.out.data(), out.out.size());
+}
+
+size_t serializeJson(const JsonDocument& doc, char* output, size_t size)
+{
+    StringPrint out;
+    serializeJson(doc, out);
+    if (size == 0)
+    {
+        return 0;
+    }
+    size_t len = std::min(size - 1, out.out.size());
+    memcpy(output, out.out.data(), len);
+    output[len] = '\0';
+    return len;
+}
+
+size_t measureJson(const JsonDocument& doc)
+{
+    StringPrint out;
+    return serializeJson(doc, out);
+}
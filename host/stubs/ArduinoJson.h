@@ -0,0 +1,120 @@
+/*
+  ANAVI Word Clock - Host build stand-in for ArduinoJson
+  Flat objects of strings, numbers and booleans only, which is all the
+  firmware stores. Nested values are rejected as invalid input.
+*/
+
+#ifndef HOST_ARDUINOJSON_H
+#define HOST_ARDUINOJSON_H
+
+#include <Arduino.h>
+#include <string>
+#include <vector>
+#include <utility>
+
+class JsonDocument;
+
+struct JsonValue {
+    enum Type { Null, Str, Num, Bool } type = Null;
+    std::string str;
+    double num = 0;
+    bool flag = false;
+};
+
+class JsonVariant {
+public:
+    JsonVariant(JsonDocument& doc, const std::string& key) : doc(doc), key(key) {}
+
+    JsonVariant& operator=(const char* s);
+    JsonVariant& operator=(char* s) { return *this = (const char*)s; }
+    JsonVariant& operator=(const String& s) { return *this = s.c_str(); }
+    JsonVariant& operator=(bool b);
+    JsonVariant& operator=(double n);
+    JsonVariant& operator=(float n) { return *this = (double)n; }
+    JsonVariant& operator=(int n) { return *this = (double)n; }
+    JsonVariant& operator=(unsigned int n) { return *this = (double)n; }
+    JsonVariant& operator=(long n) { return *this = (double)n; }
+    JsonVariant& operator=(unsigned long n) { return *this = (double)n; }
+    JsonVariant& operator=(unsigned long long n) { return *this = (double)n; }
+
+    bool isNull() const { return value() == nullptr || value()->type == JsonValue::Null; }
+    template <typename T> T as() const;
+    template <typename T> operator T() const { return as<T>(); }
+
+private:
+    const JsonValue* value() const;
+    JsonValue& slot();
+
+    JsonDocument& doc;
+    std::string key;
+};
+
+template <> const char* JsonVariant::as<const char*>() const;
+template <> String JsonVariant::as<String>() const;
+template <> double JsonVariant::as<double>() const;
+template <> float JsonVariant::as<float>() const;
+template <> int JsonVariant::as<int>() const;
+template <> long JsonVariant::as<long>() const;
+template <> unsigned int JsonVariant::as<unsigned int>() const;
+template <> unsigned long JsonVariant::as<unsigned long>() const;
+template <> uint8_t JsonVariant::as<uint8_t>() const;
+template <> bool JsonVariant::as<bool>() const;
+
+class JsonDocument {
+public:
+    explicit JsonDocument(size_t capacity) : capacity(capacity) {}
+
+    JsonVariant operator[](const char* key) { return JsonVariant(*this, key); }
+    JsonVariant operator[](const String& key) { return JsonVariant(*this, key.c_str()); }
+    bool containsKey(const char* key) const { return find(key) != nullptr; }
+    void clear() { members.clear(); }
+    size_t memoryUsage() const { return members.size() * 16; }
+
+    const JsonValue* find(const std::string& key) const;
+    JsonValue& insert(const std::string& key);
+    const std::vector<std::pair<std::string, JsonValue>>& entries() const { return members; }
+
+private:
+    size_t capacity;
+    std::vector<std::pair<std::string, JsonValue>> members;
+};
+
+template <size_t N>
+class StaticJsonDocument : public JsonDocument {
+public:
+    StaticJsonDocument() : JsonDocument(N) {}
+};
+
+class DynamicJsonDocument : public JsonDocument {
+public:
+    explicit DynamicJsonDocument(size_t capacity) : JsonDocument(capacity) {}
+};
+
+class DeserializationError {
+public:
+    enum Code { Ok, EmptyInput, IncompleteInput, InvalidInput, NoMemory };
+
+    DeserializationError(Code code = Ok) : code(code) {}
+    bool operator==(Code rhs) const { return code == rhs; }
+    bool operator!=(Code rhs) const { return code != rhs; }
+    friend bool operator==(Code lhs, const DeserializationError& rhs) { return lhs == rhs.code; }
+    friend bool operator!=(Code lhs, const DeserializationError& rhs) { return lhs != rhs.code; }
+    explicit operator bool() const { return code != Ok; }
+    const char* c_str() const;
+
+private:
+    Code code;
+};
+
+DeserializationError deserializeJson(JsonDocument& doc, const char* input);
+DeserializationError deserializeJson(JsonDocument& doc, const char* input, size_t length);
+DeserializationError deserializeJson(JsonDocument& doc, const uint8_t* input, size_t length);
+DeserializationError deserializeJson(JsonDocument& doc, const String& input);
+
+size_t serializeJson(const JsonDocument& doc, Print& output);
+size_t serializeJson(const JsonDocument& doc, char* output, size_t size);
+template <size_t N>
+size_t serializeJson(const JsonDocument& doc, char (&output)[N]) { return serializeJson(doc, output, N); }
+size_t measureJson(const JsonDocument& doc);
+
+#endif // HOST_ARDUINOJSON_H
@@ -0,0 +1,164 @@
+/*
+  ANAVI Word Clock - Host build stand-in for SPIFFS
+*/
+
+#include "SPIFFS.h"
+
+#include <map>
+
+namespace fs {
+
+struct FileData {
+    std::string contents;
+};
+
+namespace {
+
+std::map<std::string, std::shared_ptr<FileData>> files;
+
+} // namespace
+
+File::File(std::shared_ptr<FileData> data, bool writable, bool append)
+    : data(data)
+    , pos(append ? data->contents.size() : 0)
+    , writable(writable)
+{
+}
+
+size_t File::write(uint8_t c)
+{
+    return write(&c, 1);
+}
+
+size_t File::write(const uint8_t* buffer, size_t size)
+{
+    if (!data || !writable)
+    {
+        return 0;
+    }
+    if (pos + size > data->contents.size())
+    {
+        data->contents.resize(pos + size);
+    }
+    memcpy(&data->contents[pos], buffer, size);
+    pos += size;
+    return size;
+}
+
+int File::available()
+{
+    return data ? (int)(data->contents.size() - pos) : 0;
+}
+
+int File::read()
+{
+    if (!data || pos >= data->contents.size())
+    {
+        return -1;
+    }
+    return (uint8_t)data->contents[pos++];
+}
+
+int File::peek()
+{
+    if (!data || pos >= data->contents.size())
+    {
+        return -1;
+    }
+    return (uint8_t)data->contents[pos];
+}
+
+size_t File::read(uint8_t* buffer, size_t size)
+{
+    if (!data)
+    {
+        return 0;
+    }
+    size_t n = std::min(size, data->contents.size() - pos);
+    memcpy(buffer, data->contents.data() + pos, n);
+    pos += n;
+    return n;
+}
+
+bool File::seek(uint32_t position)
+{
+    if (!data || position > data->contents.size())
+    {
+        return false;
+    }
+    pos = position;
+    return true;
+}
+
+size_t File::size() const
+{
+    return data ? data->contents.size() : 0;
+}
+
+void File::close()
+{
+    data.reset();
+    pos = 0;
+}
+
+File FS::open(const char* path, const char* mode)
+{
+    const bool write = mode[0] == 'w';
+    const bool append = mode[0] == 'a';
+    auto it = files.find(path);
+    if (write || (append && it == files.end()))
+    {
+        // "w" truncates in place, so a crash here loses the old contents
+        auto data = std::make_shared<FileData>();
+        files[path] = data;
+        return File(data, true, false);
+    }
+    if (it == files.end())
+    {
+        return File();
+    }
+    return File(it->second, append, append);
+}
+
+bool FS::exists(const char* path)
+{
+    return files.count(path) != 0;
+}
+
+bool FS::remove(const char* path)
+{
+    return files.erase(path) != 0;
+}
+
+bool FS::rename(const char* pathFrom, const char* pathTo)
+{
+    // Like SPIFFS, refuse to replace an existing file
+    auto it = files.find(pathFrom);
+    if (it == files.end() || files.count(pathTo))
+    {
+        return false;
+    }
+    files[pathTo] = it->second;
+    files.erase(pathFrom);
+    return true;
+}
+
+bool SPIFFSFS::begin(bool formatOnFail, const char* basePath,
+                     uint8_t maxOpenFiles, const char* partitionLabel)
+{
+    (void)formatOnFail;
+    (void)basePath;
+    (void)maxOpenFiles;
+    (void)partitionLabel;
+    return true;
+}
+
+bool SPIFFSFS::format()
+{
+    files.clear();
+    return true;
+}
+
+} // namespace fs
+
+fs::SPIFFSFS SPIFFS;
@@ -0,0 +1,57 @@
+/*
+  ANAVI Word Clock - Host build stand-in for the ESP32 FS layer
+  Files live in memory for the lifetime of the process
+*/
+
+#ifndef HOST_FS_H
+#define HOST_FS_H
+
+#include <Arduino.h>
+#include <memory>
+#include <string>
+
+namespace fs {
+
+struct FileData;
+
+class File : public Print {
+public:
+    File() : pos(0), writable(false) {}
+    File(std::shared_ptr<FileData> data, bool writable, bool append);
+
+    operator bool() const { return (bool)data; }
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* buffer, size_t size) override;
+    using Print::write;
+    int available();
+    int read();
+    int peek();
+    size_t read(uint8_t* buffer, size_t size);
+    size_t readBytes(char* buffer, size_t length) { return read((uint8_t*)buffer, length); }
+    bool seek(uint32_t position);
+    size_t position() const { return pos; }
+    size_t size() const;
+    void flush() {}
+    void close();
+
+private:
+    std::shared_ptr<FileData> data;
+    size_t pos;
+    bool writable;
+};
+
+class FS {
+public:
+    File open(const char* path, const char* mode = "r");
+    File open(const String& path, const char* mode = "r") { return open(path.c_str(), mode); }
+    bool exists(const char* path);
+    bool remove(const char* path);
+    bool rename(const char* pathFrom, const char* pathTo);
+};
+
+} // namespace fs
+
+using fs::File;
+using fs::FS;
+
+#endif // HOST_FS_H
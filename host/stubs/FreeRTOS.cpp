@@ -0,0 +1,141 @@
+/*
+  ANAVI Word Clock - Host build stand-in for FreeRTOS tasks and critical sections
+*/
+
+#include "freertos/task.h"
+#include "Arduino.h"
+#include "HostSim.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+struct HostTask {
+    std::atomic<bool> deleted{false};
+};
+
+namespace {
+
+bool threaded = false;
+std::atomic<bool> stopping(false);
+std::atomic<int> tasksStarted(0);
+std::atomic<int> tasksParked(0);
+thread_local HostTask* currentTask = nullptr;
+
+// A stopped task sleeps for good; its thread goes down with the process
+[[noreturn]] void park()
+{
+    tasksParked++;
+    for (;;)
+    {
+        std::this_thread::sleep_for(std::chrono::hours(1));
+    }
+}
+
+// Tasks stop only inside a delay, where the firmware expects to lose the CPU
+void checkpoint()
+{
+    if (nullptr != currentTask && (stopping || currentTask->deleted))
+    {
+        park();
+    }
+}
+
+} // namespace
+
+namespace host {
+
+void setThreaded(bool on)
+{
+    threaded = on;
+}
+
+void stopTasks()
+{
+    stopping = true;
+    while (tasksParked < tasksStarted)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+} // namespace host
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t function, const char* name, uint32_t stackDepth,
+                                   void* parameters, UBaseType_t priority,
+                                   TaskHandle_t* createdTask, BaseType_t coreId)
+{
+    (void)name;
+    (void)stackDepth;
+    (void)priority;
+    (void)coreId;
+    if (!threaded)
+    {
+        return pdFAIL;
+    }
+    // Never freed, the thread may still look at it while parked
+    HostTask* task = new HostTask;
+    tasksStarted++;
+    std::thread([task, function, parameters] {
+        currentTask = task;
+        function(parameters);
+        park();
+    }).detach();
+    if (createdTask)
+    {
+        *createdTask = task;
+    }
+    return pdPASS;
+}
+
+void vTaskDelete(TaskHandle_t task)
+{
+    if (nullptr == task)
+    {
+        // The host main thread is no task and carries on
+        task = currentTask;
+    }
+    if (nullptr == task)
+    {
+        return;
+    }
+    task->deleted = true;
+    checkpoint();
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    checkpoint();
+    delay(ticks);
+    checkpoint();
+}
+
+void vTaskDelayUntil(TickType_t* previousWakeTime, TickType_t increment)
+{
+    checkpoint();
+    *previousWakeTime += increment;
+    const int64_t waitUs = (int64_t)*previousWakeTime * 1000 - (int64_t)host::nowMicros();
+    if (waitUs > 0)
+    {
+        delayMicroseconds((uint32_t)waitUs);
+    }
+    checkpoint();
+}
+
+TickType_t xTaskGetTickCount()
+{
+    return (TickType_t)millis();
+}
+
+void vPortEnterCritical(portMUX_TYPE* mux)
+{
+    while (mux->locked.exchange(true, std::memory_order_acquire))
+    {
+        std::this_thread::yield();
+    }
+}
+
+void vPortExitCritical(portMUX_TYPE* mux)
+{
+    mux->locked.store(false, std::memory_order_release);
+}
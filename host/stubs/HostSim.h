@@ -0,0 +1,101 @@
+/*
+  ANAVI Word Clock - Host simulation controls
+  Knobs used by the host drivers to steer the stand-in libraries
+*/
+
+#ifndef HOST_SIM_H
+#define HOST_SIM_H
+
+#include <cstdint>
+
+namespace host {
+
+// Simulated clock: real monotonic time plus everything delay() skipped
+uint64_t nowMicros();
+void advanceMicros(uint64_t us);
+uint64_t realMicros();
+
+// Real time: delay() sleeps on the host instead of moving the simulated
+// clock ahead. Anything run from more than one thread needs it.
+void setRealtime(bool realtime);
+
+// FreeRTOS tasks as host threads, see freertos/task.h. stopTasks() halts
+// every task at its next delay and returns once all of them have.
+void setThreaded(bool threaded);
+void stopTasks();
+
+// Crystal error of the simulated clock against the host clock
+void setClockDriftPpm(double ppm);
+
+// Unix time reported by the simulated SNTP servers at nowMicros() == 0
+void setEpoch(uint32_t epoch);
+uint32_t epoch();
+
+// Serial output (goes to stderr unless muted)
+void setSerialMuted(bool muted);
+
+// GPIO input levels seen by digitalRead()
+void setPinLevel(uint8_t pin, int level);
+
+// Efuse MAC returned by ESP.getEfuseMac(), source of the machine ID
+void setEfuseMac(uint64_t mac);
+
+// LED output statistics. Synchronous show() calls keep the CPU busy for
+// the wire time, asynchronous transfers run alongside it.
+struct LedStats {
+    uint32_t shows;
+    uint64_t busyMicros;
+    uint32_t asyncTransfers;
+    uint64_t asyncMicros;
+};
+const LedStats& ledStats();
+void recordShow(uint64_t busyMicros);
+void recordAsyncTransfer(uint64_t wireMicros);
+
+// WiFi: whether credentials are stored, whether the network is in reach,
+// and how long association plus DHCP take after WiFi.begin()
+void setWifiSaved(bool saved);
+bool wifiSaved();
+void setWifiAvailable(bool available);
+bool wifiAvailable();
+void setWifiConnectDelayMs(uint32_t ms);
+uint32_t wifiConnectDelayMs();
+
+// Battery-backed RTC: whether the chip is fitted, whether it kept the time
+// over the power cycle, and how far off that time is. Absent by default.
+void setRtc(bool present, bool holding, int32_t offsetMs);
+void setRtcDriftPpm(double ppm);
+
+// Names resolved through WiFi.hostByName(), dotted addresses excluded
+uint32_t dnsLookups();
+
+// Round trip of the simulated SNTP servers, which answer every name
+// outside localhost and any 10.x.x.x address on port 123
+void setSimNtpDelayMs(uint32_t ms);
+
+// Requests the portal pages make to the routes the firmware registers,
+// served once when the WiFiManager stand-in opens the portal
+struct PortalStats {
+    uint32_t requests;
+    uint32_t gzipResponses;
+    uint32_t chunks;
+    uint32_t bytes;
+};
+const PortalStats& portalStats();
+
+// In-process MQTT broker behind the PubSubClient stand-in
+struct MqttStats {
+    uint32_t connectAttempts;
+    uint32_t published;
+    uint32_t publishedBytes;
+    uint32_t delivered;
+};
+void setBrokerAvailable(bool available);
+// TCP connect to the broker, counted in connectAttempts; false when it is down
+bool brokerConnect();
+void mqttInject(const char* topic, const char* payload);
+const MqttStats& mqttStats();
+
+} // namespace host
+
+#endif // HOST_SIM_H
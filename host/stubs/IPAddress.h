@@ -0,0 +1,28 @@
+/*
+  ANAVI Word Clock - Host build stand-in for IPAddress
+*/
+
+#ifndef HOST_IPADDRESS_H
+#define HOST_IPADDRESS_H
+
+#include <Arduino.h>
+
+class IPAddress : public Printable {
+public:
+    IPAddress() : address(0) {}
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d)
+        : address((uint32_t)a | ((uint32_t)b << 8) | ((uint32_t)c << 16) | ((uint32_t)d << 24)) {}
+    explicit IPAddress(uint32_t raw) : address(raw) {}
+
+    operator uint32_t() const { return address; }
+    uint8_t operator[](int index) const { return (uint8_t)(address >> (index * 8)); }
+    bool operator==(const IPAddress& rhs) const { return address == rhs.address; }
+
+    String toString() const;
+    size_t printTo(Print& p) const override;
+
+private:
+    uint32_t address;  // network byte order, like the ESP32 core
+};
+
+#endif // HOST_IPADDRESS_H
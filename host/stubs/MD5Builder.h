@@ -0,0 +1,26 @@
+/*
+  ANAVI Word Clock - Host build stand-in for MD5Builder
+*/
+
+#ifndef HOST_MD5BUILDER_H
+#define HOST_MD5BUILDER_H
+
+#include <Arduino.h>
+#include <string>
+
+class MD5Builder {
+public:
+    void begin() { data.clear(); }
+    void add(const char* str) { data += str; }
+    void add(const String& str) { data += str.c_str(); }
+    void add(const uint8_t* bytes, uint16_t length) { data.append((const char*)bytes, length); }
+    void calculate();
+    void getBytes(uint8_t* output) const { memcpy(output, digest, 16); }
+    String toString() const;
+
+private:
+    std::string data;
+    uint8_t digest[16];
+};
+
+#endif // HOST_MD5BUILDER_H
@@ -0,0 +1,7 @@
+/*
+  ANAVI Word Clock - Host build stand-in for Wire
+*/
+
+#include "Wire.h"
+
+TwoWire Wire;
@@ -0,0 +1,90 @@
+/*
+  ANAVI Word Clock - Host build stand-in for Preferences
+*/
+
+#include "Preferences.h"
+#include "nvs_flash.h"
+
+#include <map>
+#include <vector>
+
+namespace {
+
+std::map<std::string, std::vector<uint8_t>>& entries()
+{
+    static std::map<std::string, std::vector<uint8_t>> store;
+    return store;
+}
+
+} // namespace
+
+bool Preferences::begin(const char* name, bool readOnly, const char* partitionLabel)
+{
+    (void)partitionLabel;
+    this->name = name;
+    this->readOnly = readOnly;
+    started = true;
+    return true;
+}
+
+bool Preferences::clear()
+{
+    if (!started || readOnly)
+    {
+        return false;
+    }
+    const std::string prefix = name + "/";
+    for (auto it = entries().begin(); it != entries().end();)
+    {
+        it = (0 == it->first.compare(0, prefix.size(), prefix)) ? entries().erase(it) : std::next(it);
+    }
+    return true;
+}
+
+bool Preferences::remove(const char* key)
+{
+    return started && !readOnly && entries().erase(path(key)) > 0;
+}
+
+bool Preferences::isKey(const char* key)
+{
+    return started && entries().count(path(key)) > 0;
+}
+
+size_t Preferences::putBytes(const char* key, const void* value, size_t length)
+{
+    if (!started || readOnly)
+    {
+        return 0;
+    }
+    const uint8_t* bytes = (const uint8_t*)value;
+    entries()[path(key)].assign(bytes, bytes + length);
+    return length;
+}
+
+size_t Preferences::getBytesLength(const char* key)
+{
+    if (!started)
+    {
+        return 0;
+    }
+    auto it = entries().find(path(key));
+    return it == entries().end() ? 0 : it->second.size();
+}
+
+size_t Preferences::getBytes(const char* key, void* buffer, size_t maxLength)
+{
+    const size_t length = getBytesLength(key);
+    if (0 == length || length > maxLength)
+    {
+        return 0;
+    }
+    memcpy(buffer, entries()[path(key)].data(), length);
+    return length;
+}
+
+esp_err_t nvs_flash_erase()
+{
+    entries().clear();
+    return ESP_OK;
+}
@@ -0,0 +1,36 @@
+/*
+  ANAVI Word Clock - Host build stand-in for Preferences
+  NVS key/value storage kept in memory, wiped by nvs_flash_erase()
+*/
+
+#ifndef HOST_PREFERENCES_H
+#define HOST_PREFERENCES_H
+
+#include <Arduino.h>
+#include <string>
+
+class Preferences {
+public:
+    Preferences() : readOnly(true), started(false) {}
+    ~Preferences() { end(); }
+
+    bool begin(const char* name, bool readOnly = false, const char* partitionLabel = nullptr);
+    void end() { started = false; }
+
+    bool clear();
+    bool remove(const char* key);
+    bool isKey(const char* key);
+
+    size_t putBytes(const char* key, const void* value, size_t length);
+    size_t getBytesLength(const char* key);
+    size_t getBytes(const char* key, void* buffer, size_t maxLength);
+
+private:
+    std::string name;
+    bool readOnly;
+    bool started;
+
+    std::string path(const char* key) const { return name + "/" + key; }
+};
+
+#endif // HOST_PREFERENCES_H
@@ -0,0 +1,58 @@
+/*
+  ANAVI Word Clock - Host build stand-in for Arduino Print
+  Minimal Print/Printable used by Serial, File and IPAddress
+*/
+
+#ifndef HOST_PRINT_H
+#define HOST_PRINT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+class Print;
+class String;
+
+class Printable {
+public:
+    virtual ~Printable() {}
+    virtual size_t printTo(Print& p) const = 0;
+};
+
+class Print {
+public:
+    virtual ~Print() {}
+
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t* buffer, size_t size);
+    size_t write(const char* str) { return str ? write((const uint8_t*)str, strlen(str)) : 0; }
+    size_t write(const char* buffer, size_t size) { return write((const uint8_t*)buffer, size); }
+
+    size_t print(const char* str);
+    size_t print(char c);
+    size_t print(const String& s);
+    size_t print(int n, int base = 10);
+    size_t print(unsigned int n, int base = 10);
+    size_t print(long n, int base = 10);
+    size_t print(unsigned long n, int base = 10);
+    size_t print(long long n, int base = 10);
+    size_t print(unsigned long long n, int base = 10);
+    size_t print(double n, int digits = 2);
+    size_t print(const Printable& p);
+
+    size_t println();
+    size_t println(const char* str) { size_t n = print(str); return n + println(); }
+    template <typename T>
+    size_t println(const T& value) { size_t n = print(value); return n + println(); }
+    template <typename T>
+    size_t println(const T& value, int format) { size_t n = print(value, format); return n + println(); }
+
+    size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+};
+
+#endif // HOST_PRINT_H
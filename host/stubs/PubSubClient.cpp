@@ -0,0 +1,224 @@
+/*
+  ANAVI Word Clock - Host build stand-in for PubSubClient
+*/
+
+#include "PubSubClient.h"
+#include "HostSim.h"
+
+#include <deque>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Commands and outages may come from another thread than the client's
+struct Broker {
+    std::recursive_mutex lock;
+    bool available = true;
+    int session = 0;
+    std::set<std::string> subscriptions;
+    std::deque<std::pair<std::string, std::string>> inbox;
+    host::MqttStats stats = {};
+} broker;
+
+} // namespace
+
+namespace host {
+
+void setBrokerAvailable(bool available)
+{
+    std::lock_guard<std::recursive_mutex> guard(broker.lock);
+    if (broker.available && !available)
+    {
+        // Dropping the broker ends the current session
+        broker.session++;
+        broker.subscriptions.clear();
+    }
+    broker.available = available;
+}
+
+void mqttInject(const char* topic, const char* payload)
+{
+    std::lock_guard<std::recursive_mutex> guard(broker.lock);
+    broker.inbox.emplace_back(topic, payload);
+}
+
+bool brokerConnect()
+{
+    std::lock_guard<std::recursive_mutex> guard(broker.lock);
+    broker.stats.connectAttempts++;
+    return broker.available;
+}
+
+const MqttStats& mqttStats()
+{
+    return broker.stats;
+}
+
+} // namespace host
+
+PubSubClient::PubSubClient(WiFiClient& client)
+    : bufferSize(256)
+    , currentState(MQTT_DISCONNECTED)
+    , session(-1)
+    , streaming(false)
+    , streamed(0)
+{
+    (void)client;
+}
+
+PubSubClient& PubSubClient::setServer(const char* domain, uint16_t port)
+{
+    (void)domain;
+    (void)port;
+    return *this;
+}
+
+PubSubClient& PubSubClient::setCallback(MQTT_CALLBACK_SIGNATURE)
+{
+    this->callback = callback;
+    return *this;
+}
+
+bool PubSubClient::connect(const char* id, const char* user, const char* pass)
+{
+    (void)id;
+    (void)user;
+    (void)pass;
+    std::lock_guard<std::recursive_mutex> guard(broker.lock);
+    if (!broker.available)
+    {
+        currentState = MQTT_CONNECTION_TIMEOUT;
+        return false;
+    }
+    session = broker.session;
+    currentState = MQTT_CONNECTED;
+    return true;
+}
+
+void PubSubClient::disconnect()
+{
+    currentState = MQTT_DISCONNECTED;
+    session = -1;
+}
+
+bool PubSubClient::connected()
+{
+    std::lock_guard<std::recursive_mutex> guard(broker.lock);
+    if (currentState == MQTT_CONNECTED && session != broker.session)
+    {
+        currentState = MQTT_CONNECTION_LOST;
+    }
+    return currentState == MQTT_CONNECTED;
+}
+
+bool PubSubClient::loop()
+{
+    if (!connected())
+    {
+        return false;
+    }
+    for (;;)
+    {
+        std::pair<std::string, std::string> message;
+        {
+            // Not held through the callback, which publishes
+            std::lock_guard<std::recursive_mutex> guard(broker.lock);
+            if (broker.inbox.empty())
+            {
+                break;
+            }
+            message = broker.inbox.front();
+            broker.inbox.pop_front();
+            if (broker.subscriptions.count(message.first) == 0)
+            {
+                continue;
+            }
+        }
+        broker.stats.delivered++;
+        if (callback)
+        {
+            std::vector<uint8_t> payload(message.second.begin(), message.second.end());
+            callback(&message.first[0], payload.data(), payload.size());
+        }
+    }
+    return true;
+}
+
+bool PubSubClient::publish(const char* topic, const char* payload, bool retained)
+{
+    return publish(topic, (const uint8_t*)payload, payload ? strlen(payload) : 0, retained);
+}
+
+bool PubSubClient::publish(const char* topic, const uint8_t* payload, unsigned int length, bool retained)
+{
+    (void)topic;
+    (void)payload;
+    (void)retained;
+    if (!connected())
+    {
+        return false;
+    }
+    broker.stats.published++;
+    broker.stats.publishedBytes += length;
+    return true;
+}
+
+bool PubSubClient::beginPublish(const char* topic, unsigned int plength, bool retained)
+{
+    (void)topic;
+    (void)plength;
+    (void)retained;
+    streaming = connected();
+    streamed = 0;
+    return streaming;
+}
+
+int PubSubClient::endPublish()
+{
+    if (!streaming)
+    {
+        return 0;
+    }
+    streaming = false;
+    broker.stats.published++;
+    broker.stats.publishedBytes += streamed;
+    return 1;
+}
+
+size_t PubSubClient::write(uint8_t c)
+{
+    return write(&c, 1);
+}
+
+size_t PubSubClient::write(const uint8_t* buffer, size_t size)
+{
+    (void)buffer;
+    if (!streaming)
+    {
+        return 0;
+    }
+    streamed += size;
+    return size;
+}
+
+bool PubSubClient::subscribe(const char* topic, uint8_t qos)
+{
+    (void)qos;
+    if (!connected())
+    {
+        return false;
+    }
+    std::lock_guard<std::recursive_mutex> guard(broker.lock);
+    broker.subscriptions.insert(topic);
+    return true;
+}
+
+bool PubSubClient::unsubscribe(const char* topic)
+{
+    std::lock_guard<std::recursive_mutex> guard(broker.lock);
+    broker.subscriptions.erase(topic);
+    return true;
+}
@@ -0,0 +1,57 @@
+/*
+  ANAVI Word Clock - Host build stand-in for PubSubClient
+  Talks to an in-process broker, see host::MqttBroker
+*/
+
+#ifndef HOST_PUBSUBCLIENT_H
+#define HOST_PUBSUBCLIENT_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <functional>
+
+#define MQTT_CONNECTION_TIMEOUT     -4
+#define MQTT_CONNECTION_LOST        -3
+#define MQTT_CONNECT_FAILED         -2
+#define MQTT_DISCONNECTED           -1
+#define MQTT_CONNECTED               0
+
+#define MQTT_CALLBACK_SIGNATURE std::function<void(char*, uint8_t*, unsigned int)> callback
+
+class PubSubClient : public Print {
+public:
+    PubSubClient(WiFiClient& client);
+
+    PubSubClient& setServer(const char* domain, uint16_t port);
+    PubSubClient& setCallback(MQTT_CALLBACK_SIGNATURE);
+    PubSubClient& setKeepAlive(uint16_t keepAlive) { (void)keepAlive; return *this; }
+    PubSubClient& setSocketTimeout(uint16_t timeout) { (void)timeout; return *this; }
+    bool setBufferSize(uint16_t size) { bufferSize = size; return true; }
+    uint16_t getBufferSize() const { return bufferSize; }
+
+    bool connect(const char* id, const char* user, const char* pass);
+    void disconnect();
+    bool connected();
+    int state() const { return currentState; }
+    bool loop();
+
+    bool publish(const char* topic, const char* payload, bool retained = false);
+    bool publish(const char* topic, const uint8_t* payload, unsigned int length, bool retained = false);
+    bool beginPublish(const char* topic, unsigned int plength, bool retained);
+    int endPublish();
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* buffer, size_t size) override;
+    using Print::write;
+    bool subscribe(const char* topic, uint8_t qos = 0);
+    bool unsubscribe(const char* topic);
+
+private:
+    std::function<void(char*, uint8_t*, unsigned int)> callback;
+    uint16_t bufferSize;
+    int currentState;
+    int session;
+    bool streaming;
+    unsigned int streamed;
+};
+
+#endif // HOST_PUBSUBCLIENT_H
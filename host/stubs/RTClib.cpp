@@ -0,0 +1,150 @@
+/*
+  ANAVI Word Clock - Host build stand-in for RTClib
+*/
+
+#include "RTClib.h"
+#include "HostSim.h"
+
+namespace {
+
+const uint8_t daysInMonth[] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30 };
+
+uint16_t date2days(uint16_t y, uint8_t m, uint8_t d)
+{
+    if (y >= 2000U)
+    {
+        y -= 2000U;
+    }
+    uint16_t days = d;
+    for (uint8_t i = 1; i < m; ++i)
+    {
+        days += daysInMonth[i - 1];
+    }
+    if (m > 2 && y % 4 == 0)
+    {
+        ++days;
+    }
+    return days + 365 * y + (y + 3) / 4 - 1;
+}
+
+// Chip time is rtcBaseUs at nowMicros() == rtcAnchorUs, running off by
+// rtcDriftPpm from there
+bool rtcPresent = false;
+bool rtcHolding = false;
+int64_t rtcBaseUs = 0;
+uint64_t rtcAnchorUs = 0;
+double rtcDriftPpm = 0;
+
+int64_t rtcNowUs()
+{
+    const double elapsed = (double)(host::nowMicros() - rtcAnchorUs);
+    return rtcBaseUs + (int64_t)(elapsed * (1.0 + rtcDriftPpm / 1e6));
+}
+
+} // namespace
+
+namespace host {
+
+void setRtc(bool present, bool holding, int32_t offsetMs)
+{
+    rtcPresent = present;
+    rtcHolding = holding;
+    rtcAnchorUs = nowMicros();
+    rtcBaseUs = ((int64_t)epoch() * 1000000 + (int64_t)rtcAnchorUs) + (int64_t)offsetMs * 1000;
+}
+
+void setRtcDriftPpm(double ppm)
+{
+    rtcBaseUs = rtcNowUs();
+    rtcAnchorUs = nowMicros();
+    rtcDriftPpm = ppm;
+}
+
+} // namespace host
+
+bool RTC_DS3231::begin(TwoWire* wireInstance)
+{
+    (void)wireInstance;
+    return rtcPresent;
+}
+
+bool RTC_DS3231::lostPower()
+{
+    return !rtcHolding;
+}
+
+void RTC_DS3231::adjust(const DateTime& dt)
+{
+    // Writing the seconds register restarts the countdown to the next one
+    rtcAnchorUs = host::nowMicros();
+    rtcBaseUs = (int64_t)dt.unixtime() * 1000000;
+    rtcHolding = true;
+}
+
+DateTime RTC_DS3231::now()
+{
+    return DateTime((uint32_t)(rtcNowUs() / 1000000));
+}
+
+DateTime::DateTime(uint32_t t)
+{
+    t -= SECONDS_FROM_1970_TO_2000;
+    ss = t % 60;
+    t /= 60;
+    mm = t % 60;
+    t /= 60;
+    hh = t % 24;
+    uint16_t days = t / 24;
+    uint8_t leap;
+    for (yOff = 0;; ++yOff)
+    {
+        leap = yOff % 4 == 0;
+        if (days < 365U + leap)
+        {
+            break;
+        }
+        days -= 365 + leap;
+    }
+    for (m = 1; m < 12; ++m)
+    {
+        uint8_t daysPerMonth = daysInMonth[m - 1];
+        if (leap && m == 2)
+        {
+            ++daysPerMonth;
+        }
+        if (days < daysPerMonth)
+        {
+            break;
+        }
+        days -= daysPerMonth;
+    }
+    d = days + 1;
+}
+
+DateTime::DateTime(uint16_t year, uint8_t month, uint8_t day,
+                   uint8_t hour, uint8_t min, uint8_t sec)
+{
+    if (year >= 2000U)
+    {
+        year -= 2000U;
+    }
+    yOff = year;
+    m = month;
+    d = day;
+    hh = hour;
+    mm = min;
+    ss = sec;
+}
+
+uint8_t DateTime::dayOfTheWeek() const
+{
+    uint16_t day = date2days(yOff, m, d);
+    return (day + 6) % 7;  // Jan 1, 2000 is a Saturday, i.e. returns 6
+}
+
+uint32_t DateTime::unixtime() const
+{
+    uint16_t days = date2days(yOff, m, d);
+    uint32_t t = ((days * 24UL + hh) * 60 + mm) * 60 + ss;
+    return t + SECONDS_FROM_1970_TO_2000;
+}
@@ -0,0 +1,42 @@
+/*
+  ANAVI Word Clock - Host build stand-in for RTClib
+*/
+
+#ifndef HOST_RTCLIB_H
+#define HOST_RTCLIB_H
+
+#include <Arduino.h>
+#include <Wire.h>
+
+#define SECONDS_FROM_1970_TO_2000 946684800
+
+class DateTime {
+public:
+    DateTime(uint32_t t = SECONDS_FROM_1970_TO_2000);
+    DateTime(uint16_t year, uint8_t month, uint8_t day,
+             uint8_t hour = 0, uint8_t min = 0, uint8_t sec = 0);
+
+    uint16_t year() const { return 2000U + yOff; }
+    uint8_t month() const { return m; }
+    uint8_t day() const { return d; }
+    uint8_t hour() const { return hh; }
+    uint8_t twelveHour() const { return (hh % 12 == 0) ? 12 : hh % 12; }
+    uint8_t minute() const { return mm; }
+    uint8_t second() const { return ss; }
+    uint8_t dayOfTheWeek() const;
+    uint32_t unixtime() const;
+
+protected:
+    uint8_t yOff, m, d, hh, mm, ss;
+};
+
+// Battery-backed DS3231 on the simulated clock, see host::setRtc()
+class RTC_DS3231 {
+public:
+    bool begin(TwoWire* wireInstance = &Wire);
+    bool lostPower();
+    void adjust(const DateTime& dt);
+    DateTime now();
+};
+
+#endif // HOST_RTCLIB_H
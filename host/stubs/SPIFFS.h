@@ -0,0 +1,24 @@
+/*
+  ANAVI Word Clock - Host build stand-in for SPIFFS
+*/
+
+#ifndef HOST_SPIFFS_H
+#define HOST_SPIFFS_H
+
+#include "FS.h"
+
+namespace fs {
+
+class SPIFFSFS : public FS {
+public:
+    bool begin(bool formatOnFail = false, const char* basePath = "/spiffs",
+               uint8_t maxOpenFiles = 10, const char* partitionLabel = nullptr);
+    bool format();
+    void end() {}
+};
+
+} // namespace fs
+
+extern fs::SPIFFSFS SPIFFS;
+
+#endif // HOST_SPIFFS_H
@@ -0,0 +1,53 @@
+/*
+  ANAVI Word Clock - Host build stand-in for Arduino String
+  Thin wrapper over std::string covering the calls the firmware makes
+*/
+
+#ifndef HOST_WSTRING_H
+#define HOST_WSTRING_H
+
+#include <string>
+#include <cstring>
+#include <cstdlib>
+
+class String {
+public:
+    String() {}
+    String(const char* s) : str(s ? s : "") {}
+    String(const std::string& s) : str(s) {}
+    String(char c) : str(1, c) {}
+    explicit String(int value) : str(std::to_string(value)) {}
+    explicit String(unsigned int value) : str(std::to_string(value)) {}
+    explicit String(long value) : str(std::to_string(value)) {}
+    explicit String(unsigned long value) : str(std::to_string(value)) {}
+    String(float value, unsigned int decimals = 2);
+    String(double value, unsigned int decimals = 2);
+
+    const char* c_str() const { return str.c_str(); }
+    unsigned int length() const { return str.length(); }
+    bool isEmpty() const { return str.empty(); }
+
+    String substring(unsigned int from) const;
+    String substring(unsigned int from, unsigned int to) const;
+    bool equals(const String& other) const { return str == other.str; }
+    bool equalsIgnoreCase(const String& other) const;
+    void toCharArray(char* buf, unsigned int bufsize) const;
+    int toInt() const { return atoi(str.c_str()); }
+    float toFloat() const { return (float)atof(str.c_str()); }
+
+    String& operator+=(const String& rhs) { str += rhs.str; return *this; }
+    String& operator+=(const char* rhs) { str += rhs; return *this; }
+    String& operator+=(char c) { str += c; return *this; }
+    char operator[](unsigned int index) const { return index < str.size() ? str[index] : 0; }
+    bool operator==(const String& rhs) const { return str == rhs.str; }
+    bool operator==(const char* rhs) const { return str == rhs; }
+    bool operator!=(const String& rhs) const { return str != rhs.str; }
+
+    friend String operator+(const String& lhs, const String& rhs) { return String(lhs.str + rhs.str); }
+    friend String operator+(const String& lhs, const char* rhs) { return String(lhs.str + rhs); }
+
+private:
+    std::string str;
+};
+
+#endif // HOST_WSTRING_H
@@ -0,0 +1,75 @@
+/*
+  ANAVI Word Clock - Host build stand-in for the ESP32 WebServer
+*/
+
+#include "WebServer.h"
+#include "HostSim.h"
+
+namespace {
+
+host::PortalStats portalStats = { 0, 0, 0, 0 };
+
+} // namespace
+
+namespace host {
+
+const PortalStats& portalStats() { return ::portalStats; }
+
+} // namespace host
+
+void WebServer::on(const char* uri, HTTPMethod method, THandlerFunction handler)
+{
+    (void)method;
+    routes.push_back({ uri, handler });
+}
+
+void WebServer::sendHeader(const String& name, const String& value, bool first)
+{
+    (void)first;
+    if (name.equalsIgnoreCase("Content-Encoding") && value.equalsIgnoreCase("gzip"))
+    {
+        portalStats.gzipResponses++;
+    }
+}
+
+void WebServer::send(int code, const char* contentType, const String& content)
+{
+    (void)code;
+    (void)contentType;
+    if (content.length())
+    {
+        sendContent(content);
+    }
+}
+
+void WebServer::send_P(int code, PGM_P contentType, PGM_P content, size_t length)
+{
+    (void)code;
+    (void)contentType;
+    sendContent(content, length);
+}
+
+void WebServer::sendContent(const char* content, size_t length)
+{
+    (void)content;
+    if (length)
+    {
+        portalStats.chunks++;
+        portalStats.bytes += length;
+    }
+}
+
+bool WebServer::request(const char* uri)
+{
+    for (const Route& route : routes)
+    {
+        if (0 == strcmp(route.uri, uri))
+        {
+            contentLength = CONTENT_LENGTH_UNKNOWN;
+            portalStats.requests++;
+            route.handler();
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,49 @@
+/*
+  ANAVI Word Clock - Host build stand-in for the ESP32 WebServer
+  Routes are called directly by request(), which counts what they send
+*/
+
+#ifndef HOST_WEBSERVER_H
+#define HOST_WEBSERVER_H
+
+#include <Arduino.h>
+#include <functional>
+#include <vector>
+
+#define CONTENT_LENGTH_UNKNOWN ((size_t)-1)
+
+typedef enum {
+    HTTP_ANY,
+    HTTP_GET,
+    HTTP_POST
+} HTTPMethod;
+
+class WebServer {
+public:
+    typedef std::function<void(void)> THandlerFunction;
+
+    explicit WebServer(int port = 80) { (void)port; }
+
+    void on(const char* uri, THandlerFunction handler) { on(uri, HTTP_ANY, handler); }
+    void on(const char* uri, HTTPMethod method, THandlerFunction handler);
+
+    void sendHeader(const String& name, const String& value, bool first = false);
+    void setContentLength(size_t length) { contentLength = length; }
+    void send(int code, const char* contentType = nullptr, const String& content = String());
+    void send_P(int code, PGM_P contentType, PGM_P content, size_t length);
+    void sendContent(const char* content, size_t length);
+    void sendContent(const String& content) { sendContent(content.c_str(), content.length()); }
+
+    // Host only: run the handler for uri, false when there is none
+    bool request(const char* uri);
+
+private:
+    struct Route {
+        const char* uri;
+        THandlerFunction handler;
+    };
+    std::vector<Route> routes;
+    size_t contentLength = CONTENT_LENGTH_UNKNOWN;
+};
+
+#endif // HOST_WEBSERVER_H
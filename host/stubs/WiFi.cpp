@@ -0,0 +1,201 @@
+/*
+  ANAVI Word Clock - Host build stand-in for WiFi and WiFiManager
+*/
+
+#include "WiFi.h"
+#include "WiFiManager.h"
+#include "HostSim.h"
+
+#include <atomic>
+
+WiFiClass WiFi;
+
+namespace {
+
+bool credentialsSaved = true;
+std::atomic<bool> networkAvailable(true);  // outages come from the bench thread
+uint32_t connectDelayMs = 1500;
+uint32_t lookups = 0;
+
+} // namespace
+
+namespace host {
+
+void setWifiSaved(bool saved) { credentialsSaved = saved; }
+bool wifiSaved() { return credentialsSaved; }
+void setWifiAvailable(bool available) { networkAvailable = available; }
+bool wifiAvailable() { return networkAvailable; }
+void setWifiConnectDelayMs(uint32_t ms) { connectDelayMs = ms; }
+uint32_t wifiConnectDelayMs() { return connectDelayMs; }
+uint32_t dnsLookups() { return lookups; }
+
+} // namespace host
+
+String IPAddress::toString() const
+{
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%u.%u.%u.%u", (*this)[0], (*this)[1], (*this)[2], (*this)[3]);
+    return String(buf);
+}
+
+size_t IPAddress::printTo(Print& p) const
+{
+    return p.print(toString());
+}
+
+wl_status_t WiFiClass::begin()
+{
+    started = true;
+    startedAt = host::nowMicros();
+    return WL_DISCONNECTED;
+}
+
+wl_status_t WiFiClass::begin(const char* ssid, const char* passphrase)
+{
+    (void)ssid;
+    (void)passphrase;
+    return begin();
+}
+
+wl_status_t WiFiClass::status()
+{
+    if (!started || !host::wifiAvailable())
+    {
+        return WL_DISCONNECTED;
+    }
+    return host::nowMicros() - startedAt >= (uint64_t)host::wifiConnectDelayMs() * 1000
+        ? WL_CONNECTED : WL_DISCONNECTED;
+}
+
+bool WiFiClass::disconnect(bool wifiOff)
+{
+    (void)wifiOff;
+    started = false;
+    return true;
+}
+
+int WiFiClass::hostByName(const char* host, IPAddress& result)
+{
+    unsigned int a, b, c, d;
+    char tail;
+    if (4 == sscanf(host, "%u.%u.%u.%u%c", &a, &b, &c, &d, &tail) && (a | b | c | d) < 256)
+    {
+        result = IPAddress(a, b, c, d);
+        return 1;
+    }
+    lookups++;
+    if (0 == strcmp(host, "localhost"))
+    {
+        result = IPAddress(127, 0, 0, 1);
+        return 1;
+    }
+    // Other names get a stable address in 10.0.0.0/24, where the simulated
+    // services in WiFiUdp.cpp answer
+    uint32_t hash = 2166136261UL;
+    for (const char* p = host; *p; p++)
+    {
+        hash = (hash ^ (uint8_t)*p) * 16777619UL;
+    }
+    result = IPAddress(10, 0, 0, 1 + hash % 254);
+    return 1;
+}
+
+WiFiManagerParameter::WiFiManagerParameter(const char* custom)
+    : id(nullptr)
+    , label(nullptr)
+    , customHTML(custom)
+    , custom(nullptr)
+    , value(nullptr)
+    , length(0)
+{
+}
+
+WiFiManagerParameter::WiFiManagerParameter(const char* id, const char* label,
+                                           const char* defaultValue, int length,
+                                           const char* custom)
+    : id(id)
+    , label(label)
+    , customHTML(nullptr)
+    , custom(custom)
+    , value(nullptr)
+    , length(0)
+{
+    setValue(defaultValue, length);
+}
+
+WiFiManagerParameter::~WiFiManagerParameter()
+{
+    delete[] value;
+}
+
+void WiFiManagerParameter::setValue(const char* defaultValue, int newLength)
+{
+    delete[] value;
+    length = newLength;
+    value = new char[length + 1]();
+    if (defaultValue)
+    {
+        strncpy(value, defaultValue, length);
+    }
+}
+
+bool WiFiManager::autoConnect(const char* apName, const char* apPassword)
+{
+    (void)apPassword;
+    // Stored credentials are assumed to work, so the portal never opens
+    portalSSID = apName;
+    WiFi.begin();
+    return true;
+}
+
+bool WiFiManager::getWiFiIsSaved()
+{
+    return host::wifiSaved();
+}
+
+bool WiFiManager::startConfigPortal(const char* apName, const char* apPassword)
+{
+    (void)apPassword;
+    portalSSID = apName;
+    portalActive = true;
+    portalStartedAt = host::nowMicros();
+    if (apCallback)
+    {
+        apCallback(this);
+    }
+    server.reset(new WebServer(80));
+    if (webServerCallback)
+    {
+        webServerCallback();
+    }
+    // One page load: the head script, then whatever it fetches
+    for (const char* uri : { "/portal.js", "/portal/id", "/portal/tz" })
+    {
+        server->request(uri);
+    }
+    // The form is taken to be submitted at once with the values shown
+    if (saveConfigCallback)
+    {
+        saveConfigCallback();
+    }
+    WiFi.begin();
+    return blocking ? WL_CONNECTED == WiFi.status() : false;
+}
+
+bool WiFiManager::process()
+{
+    if (!portalActive)
+    {
+        return false;
+    }
+    if (WL_CONNECTED == WiFi.status())
+    {
+        portalActive = false;
+        return true;
+    }
+    if (timeout && host::nowMicros() - portalStartedAt >= (uint64_t)timeout * 1000000)
+    {
+        portalActive = false;
+    }
+    return false;
+}
@@ -0,0 +1,61 @@
+/*
+  ANAVI Word Clock - Host build stand-in for the ESP32 WiFi library
+*/
+
+#ifndef HOST_WIFI_H
+#define HOST_WIFI_H
+
+#include <Arduino.h>
+#include "IPAddress.h"
+
+typedef enum {
+    WL_IDLE_STATUS = 0,
+    WL_NO_SSID_AVAIL = 1,
+    WL_CONNECTED = 3,
+    WL_CONNECT_FAILED = 4,
+    WL_CONNECTION_LOST = 5,
+    WL_DISCONNECTED = 6
+} wl_status_t;
+
+typedef enum {
+    WIFI_OFF = 0,
+    WIFI_STA = 1,
+    WIFI_AP = 2,
+    WIFI_AP_STA = 3
+} wifi_mode_t;
+
+class WiFiClient {
+public:
+    WiFiClient() : fd(-1) {}
+    // Takes over a connected socket, see lwip/sockets.h
+    explicit WiFiClient(int socket) : fd(socket) {}
+    int connect(const char* host, uint16_t port) { (void)host; (void)port; return 1; }
+    bool connected() { return true; }
+    void stop() {}
+    void setTimeout(uint32_t seconds) { (void)seconds; }
+    void setConnectionTimeout(uint32_t milliseconds) { (void)milliseconds; }
+
+private:
+    int fd;
+};
+
+class WiFiClass {
+public:
+    WiFiClass() : started(false), startedAt(0) {}
+    bool mode(wifi_mode_t mode) { (void)mode; return true; }
+    // Associates host::wifiConnectDelayMs() after the call, if available
+    wl_status_t begin();
+    wl_status_t begin(const char* ssid, const char* passphrase = nullptr);
+    wl_status_t status();
+    IPAddress localIP() { return IPAddress(192, 168, 4, 2); }
+    bool disconnect(bool wifiOff = false);
+    int hostByName(const char* host, IPAddress& result);
+
+private:
+    bool started;
+    uint64_t startedAt;
+};
+
+extern WiFiClass WiFi;
+
+#endif // HOST_WIFI_H
@@ -0,0 +1,82 @@
+/*
+  ANAVI Word Clock - Host build stand-in for WiFiManager
+  Stored credentials and the portal are driven by the host WiFi knobs
+*/
+
+#ifndef HOST_WIFIMANAGER_H
+#define HOST_WIFIMANAGER_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <WebServer.h>
+#include <functional>
+#include <memory>
+#include <vector>
+
+class WiFiManagerParameter {
+public:
+    explicit WiFiManagerParameter(const char* custom);
+    WiFiManagerParameter(const char* id, const char* label, const char* defaultValue, int length,
+                         const char* custom = "");
+    ~WiFiManagerParameter();
+
+    const char* getID() const { return id; }
+    const char* getValue() const { return value; }
+    const char* getLabel() const { return label; }
+    int getValueLength() const { return length; }
+    const char* getCustomHTML() const { return customHTML; }
+    // Extra attributes of the input element
+    const char* getCustom() const { return custom; }
+    void setValue(const char* defaultValue, int length);
+
+private:
+    const char* id;
+    const char* label;
+    const char* customHTML;
+    const char* custom;
+    char* value;
+    int length;
+};
+
+class WiFiManager {
+public:
+    WiFiManager()
+        : saveConfigCallback(nullptr), apCallback(nullptr), timeout(0)
+        , blocking(true), portalActive(false), portalStartedAt(0) {}
+
+    bool autoConnect(const char* apName, const char* apPassword = nullptr);
+    bool getWiFiIsSaved();
+    // Non-blocking portal: startConfigPortal() returns at once and
+    // process() reports true once the submitted network is joined
+    void setConfigPortalBlocking(bool shouldBlock) { blocking = shouldBlock; }
+    bool startConfigPortal(const char* apName, const char* apPassword = nullptr);
+    bool process();
+    bool getConfigPortalActive() const { return portalActive; }
+    bool stopConfigPortal() { portalActive = false; return true; }
+    void setSaveConfigCallback(void (*func)()) { saveConfigCallback = func; }
+    void setAPCallback(void (*func)(WiFiManager*)) { apCallback = func; }
+    // Called once the portal's web server is up, to add routes to it
+    void setWebServerCallback(std::function<void()> func) { webServerCallback = func; }
+    void setCustomHeadElement(const char* html) { (void)html; }
+    void setTimeout(unsigned long seconds) { timeout = seconds; }
+    void setConfigPortalTimeout(unsigned long seconds) { timeout = seconds; }
+    bool addParameter(WiFiManagerParameter* p) { params.push_back(p); return true; }
+    String getConfigPortalSSID() const { return portalSSID; }
+    void resetSettings() {}
+
+    // Portal web server, only while the portal is open
+    std::unique_ptr<WebServer> server;
+
+private:
+    void (*saveConfigCallback)();
+    void (*apCallback)(WiFiManager*);
+    std::function<void()> webServerCallback;
+    unsigned long timeout;
+    bool blocking;
+    bool portalActive;
+    uint64_t portalStartedAt;
+    std::vector<WiFiManagerParameter*> params;
+    String portalSSID;
+};
+
+#endif // HOST_WIFIMANAGER_H
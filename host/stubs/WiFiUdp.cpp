@@ -0,0 +1,199 @@
+/*
+  ANAVI Word Clock - Host build stand-in for WiFiUdp
+*/
+
+#include "WiFiUdp.h"
+#include "HostSim.h"
+
+#include <arpa/inet.h>
+#include <deque>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+
+#define NTP_UNIX_DELTA 2208988800ULL
+
+uint32_t simNtpDelayMs = 20;
+
+// Replies from the simulated SNTP servers, released on the simulated clock
+struct SimReply {
+    const WiFiUDP* socket;
+    uint64_t deliverAt;
+    IPAddress from;
+    uint16_t port;
+    uint8_t packet[48];
+};
+std::deque<SimReply> simReplies;
+
+bool isSimNtp(IPAddress ip, uint16_t port)
+{
+    return 123 == port && 10 == ip[0];
+}
+
+void writeTimestamp(uint8_t* out, uint64_t unixUs)
+{
+    const uint32_t seconds = (uint32_t)(unixUs / 1000000 + NTP_UNIX_DELTA);
+    const uint32_t fraction = (uint32_t)(((unixUs % 1000000) << 32) / 1000000);
+    for (int i = 0; i < 4; i++)
+    {
+        out[i] = (uint8_t)(seconds >> (24 - 8 * i));
+        out[4 + i] = (uint8_t)(fraction >> (24 - 8 * i));
+    }
+}
+
+void answerSimNtp(const WiFiUDP* socket, IPAddress ip, const std::vector<uint8_t>& request)
+{
+    if (request.size() < 48 || WL_CONNECTED != WiFi.status())
+    {
+        return;
+    }
+    SimReply reply;
+    reply.socket = socket;
+    const uint64_t now = host::nowMicros();
+    reply.deliverAt = now + (uint64_t)simNtpDelayMs * 1000;
+    reply.from = ip;
+    reply.port = 123;
+    memset(reply.packet, 0, sizeof(reply.packet));
+    reply.packet[0] = 0x24;  // LI 0, version 4, mode 4 (server)
+    reply.packet[1] = 2;     // stratum
+    memcpy(reply.packet + 24, request.data() + 40, 8);
+    // Symmetric path: the request arrives half way through the round trip
+    const uint64_t serverUs = (uint64_t)host::epoch() * 1000000 + now + simNtpDelayMs * 500ULL;
+    writeTimestamp(reply.packet + 16, serverUs);
+    writeTimestamp(reply.packet + 32, serverUs);
+    writeTimestamp(reply.packet + 40, serverUs);
+    simReplies.push_back(reply);
+}
+
+} // namespace
+
+namespace host {
+
+void setSimNtpDelayMs(uint32_t ms) { simNtpDelayMs = ms; }
+
+} // namespace host
+
+uint8_t WiFiUDP::begin(uint16_t port)
+{
+    stop();
+    fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0)
+    {
+        return 0;
+    }
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    const int yes = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+    sockaddr_in local = {};
+    local.sin_family = AF_INET;
+    local.sin_addr.s_addr = htonl(INADDR_ANY);
+    local.sin_port = htons(port);
+    if (bind(fd, (sockaddr*)&local, sizeof(local)) < 0)
+    {
+        // Taken on this workstation, any free port does for a client
+        local.sin_port = 0;
+        if (bind(fd, (sockaddr*)&local, sizeof(local)) < 0)
+        {
+            stop();
+            return 0;
+        }
+    }
+    return 1;
+}
+
+void WiFiUDP::stop()
+{
+    if (fd >= 0)
+    {
+        close(fd);
+        fd = -1;
+    }
+    for (auto it = simReplies.begin(); it != simReplies.end();)
+    {
+        it = (it->socket == this) ? simReplies.erase(it) : it + 1;
+    }
+}
+
+int WiFiUDP::beginPacket(IPAddress ip, uint16_t port)
+{
+    txIP = ip;
+    txPort = port;
+    tx.clear();
+    return fd >= 0 ? 1 : 0;
+}
+
+size_t WiFiUDP::write(const uint8_t* buffer, size_t size)
+{
+    tx.insert(tx.end(), buffer, buffer + size);
+    return size;
+}
+
+int WiFiUDP::endPacket()
+{
+    if (fd < 0)
+    {
+        return 0;
+    }
+    if (isSimNtp(txIP, txPort))
+    {
+        answerSimNtp(this, txIP, tx);
+        return 1;
+    }
+    sockaddr_in remote = {};
+    remote.sin_family = AF_INET;
+    remote.sin_addr.s_addr = (uint32_t)txIP;  // both in network byte order
+    remote.sin_port = htons(txPort);
+    return sendto(fd, tx.data(), tx.size(), 0, (sockaddr*)&remote, sizeof(remote)) ==
+           (ssize_t)tx.size() ? 1 : 0;
+}
+
+int WiFiUDP::parsePacket()
+{
+    rx.clear();
+    rxPos = 0;
+    const uint64_t now = host::nowMicros();
+    for (auto it = simReplies.begin(); it != simReplies.end(); ++it)
+    {
+        if (it->socket == this && it->deliverAt <= now)
+        {
+            rx.assign(it->packet, it->packet + sizeof(it->packet));
+            rxIP = it->from;
+            rxPort = it->port;
+            simReplies.erase(it);
+            return (int)rx.size();
+        }
+    }
+    if (fd < 0)
+    {
+        return 0;
+    }
+    uint8_t buffer[1500];
+    sockaddr_in remote = {};
+    socklen_t remoteLength = sizeof(remote);
+    const ssize_t length = recvfrom(fd, buffer, sizeof(buffer), MSG_DONTWAIT,
+                                    (sockaddr*)&remote, &remoteLength);
+    if (length <= 0)
+    {
+        return 0;
+    }
+    rx.assign(buffer, buffer + length);
+    rxIP = IPAddress((uint32_t)remote.sin_addr.s_addr);
+    rxPort = ntohs(remote.sin_port);
+    return (int)length;
+}
+
+int WiFiUDP::read()
+{
+    return rxPos < rx.size() ? rx[rxPos++] : -1;
+}
+
+int WiFiUDP::read(uint8_t* buffer, size_t len)
+{
+    const size_t count = std::min(len, rx.size() - rxPos);
+    memcpy(buffer, rx.data() + rxPos, count);
+    rxPos += count;
+    return (int)count;
+}
@@ -0,0 +1,45 @@
+/*
+  ANAVI Word Clock - Host build stand-in for WiFiUdp
+  Real non-blocking datagram sockets, except that port 123 on 10.x.x.x is
+  answered in process by a simulated SNTP server on the simulated clock
+*/
+
+#ifndef HOST_WIFIUDP_H
+#define HOST_WIFIUDP_H
+
+#include <WiFi.h>
+#include <vector>
+
+class WiFiUDP {
+public:
+    WiFiUDP() : fd(-1), txPort(0), rxPos(0), rxPort(0) {}
+    ~WiFiUDP() { stop(); }
+
+    uint8_t begin(uint16_t port);
+    void stop();
+
+    int beginPacket(IPAddress ip, uint16_t port);
+    size_t write(uint8_t c) { return write(&c, 1); }
+    size_t write(const uint8_t* buffer, size_t size);
+    int endPacket();
+
+    int parsePacket();
+    int available() const { return (int)(rx.size() - rxPos); }
+    int read();
+    int read(uint8_t* buffer, size_t len);
+    void flush() { rxPos = rx.size(); }
+    IPAddress remoteIP() const { return rxIP; }
+    uint16_t remotePort() const { return rxPort; }
+
+private:
+    int fd;
+    IPAddress txIP;
+    uint16_t txPort;
+    std::vector<uint8_t> tx;
+    std::vector<uint8_t> rx;
+    size_t rxPos;
+    IPAddress rxIP;
+    uint16_t rxPort;
+};
+
+#endif // HOST_WIFIUDP_H
@@ -0,0 +1,17 @@
+/*
+  ANAVI Word Clock - Host build stand-in for Wire
+*/
+
+#ifndef HOST_WIRE_H
+#define HOST_WIRE_H
+
+#include <Arduino.h>
+
+class TwoWire {
+public:
+    bool begin() { return true; }
+};
+
+extern TwoWire Wire;
+
+#endif // HOST_WIRE_H
@@ -0,0 +1,26 @@
+/*
+  ANAVI Word Clock - Host build stand-in for FreeRTOS tasks
+  Tasks are host threads, and only start once host::setThreaded(true);
+  otherwise creating one fails, as it would when out of memory. Threads
+  run in parallel and ignore priorities and core pinning.
+*/
+
+#ifndef HOST_FREERTOS_TASK_H
+#define HOST_FREERTOS_TASK_H
+
+#include "FreeRTOS.h"
+
+struct HostTask;
+typedef HostTask* TaskHandle_t;
+typedef void (*TaskFunction_t)(void*);
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t function, const char* name, uint32_t stackDepth,
+                                   void* parameters, UBaseType_t priority,
+                                   TaskHandle_t* createdTask, BaseType_t coreId);
+// nullptr deletes the calling task; another task stops at its next delay
+void vTaskDelete(TaskHandle_t task);
+void vTaskDelay(TickType_t ticks);
+void vTaskDelayUntil(TickType_t* previousWakeTime, TickType_t increment);
+TickType_t xTaskGetTickCount();
+
+#endif // HOST_FREERTOS_TASK_H
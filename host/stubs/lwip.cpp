@@ -0,0 +1,151 @@
+/*
+  ANAVI Word Clock - Host build stand-in for lwIP
+*/
+
+#include "lwip/dns.h"
+#include "lwip/sockets.h"
+#include "lwip/tcpip.h"
+#include "HostSim.h"
+#include <WiFi.h>
+
+#include <map>
+
+namespace {
+
+// Round trip of the TCP handshake with the broker
+const uint64_t BROKER_HANDSHAKE_US = 20000;
+
+struct Socket {
+    int flags;
+    bool connecting;
+    uint64_t readyAt;  // simulated clock
+    int error;
+};
+
+std::map<int, Socket> sockets;
+int nextSocket = 100;
+
+} // namespace
+
+err_t dns_gethostbyname(const char* hostname, ip_addr_t* address, dns_found_callback found, void* arg)
+{
+    (void)found;
+    (void)arg;
+    IPAddress resolved;
+    if (!WiFi.hostByName(hostname, resolved))
+    {
+        return ERR_ARG;
+    }
+    address->addr = (uint32_t)resolved;
+    return ERR_OK;
+}
+
+err_t tcpip_callback(tcpip_callback_fn function, void* ctx)
+{
+    function(ctx);
+    return ERR_OK;
+}
+
+int lwip_socket(int domain, int type, int protocol)
+{
+    (void)domain;
+    (void)type;
+    (void)protocol;
+    sockets[nextSocket] = Socket{ 0, false, 0, 0 };
+    return nextSocket++;
+}
+
+int lwip_connect(int s, const struct sockaddr* name, socklen_t namelen)
+{
+    (void)name;
+    (void)namelen;
+    auto it = sockets.find(s);
+    if (it == sockets.end())
+    {
+        errno = EBADF;
+        return -1;
+    }
+    // Any address reaches the broker; one that is down refuses
+    Socket& socket = it->second;
+    socket.connecting = true;
+    socket.readyAt = host::nowMicros() + BROKER_HANDSHAKE_US;
+    socket.error = host::brokerConnect() ? 0 : ECONNREFUSED;
+    if (socket.flags & O_NONBLOCK)
+    {
+        errno = EINPROGRESS;
+        return -1;
+    }
+    delayMicroseconds(BROKER_HANDSHAKE_US);
+    socket.connecting = false;
+    errno = socket.error;
+    return socket.error ? -1 : 0;
+}
+
+int lwip_select(int maxfdp1, fd_set* readset, fd_set* writeset, fd_set* exceptset,
+                struct timeval* timeout)
+{
+    (void)exceptset;
+    (void)timeout;
+    // Only a connect in progress is ever waited for
+    int ready = 0;
+    for (int s = 0; s < maxfdp1; s++)
+    {
+        auto it = sockets.find(s);
+        if (writeset && FD_ISSET(s, writeset))
+        {
+            if (it != sockets.end() && host::nowMicros() >= it->second.readyAt)
+            {
+                it->second.connecting = false;
+                ready++;
+            }
+            else
+            {
+                FD_CLR(s, writeset);
+            }
+        }
+        if (readset)
+        {
+            FD_CLR(s, readset);
+        }
+    }
+    return ready;
+}
+
+int lwip_getsockopt(int s, int level, int optname, void* optval, socklen_t* optlen)
+{
+    auto it = sockets.find(s);
+    if (it == sockets.end() || SOL_SOCKET != level || SO_ERROR != optname || *optlen < sizeof(int))
+    {
+        errno = EINVAL;
+        return -1;
+    }
+    *(int*)optval = it->second.connecting ? 0 : it->second.error;
+    *optlen = sizeof(int);
+    return 0;
+}
+
+int lwip_fcntl(int s, int cmd, int val)
+{
+    auto it = sockets.find(s);
+    if (it == sockets.end())
+    {
+        errno = EBADF;
+        return -1;
+    }
+    if (F_GETFL == cmd)
+    {
+        return it->second.flags;
+    }
+    if (F_SETFL == cmd)
+    {
+        it->second.flags = val;
+        return 0;
+    }
+    errno = EINVAL;
+    return -1;
+}
+
+int lwip_close(int s)
+{
+    return sockets.erase(s) ? 0 : -1;
+}
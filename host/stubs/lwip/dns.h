@@ -0,0 +1,30 @@
+/*
+  ANAVI Word Clock - Host build stand-in for the lwIP resolver
+  Names resolve at once, to the addresses WiFi.hostByName() hands out
+*/
+
+#ifndef HOST_LWIP_DNS_H
+#define HOST_LWIP_DNS_H
+
+#include <cstdint>
+
+typedef int8_t err_t;
+#define ERR_OK 0
+#define ERR_MEM -1
+#define ERR_INPROGRESS -5
+#define ERR_ARG -16
+
+struct ip4_addr_t {
+    uint32_t addr;  // network byte order
+};
+typedef ip4_addr_t ip_addr_t;
+
+#define IP_IS_V4(address) true
+#define ip_2_ip4(address) (address)
+#define ip4_addr_get_u32(address) ((address)->addr)
+
+typedef void (*dns_found_callback)(const char* name, const ip_addr_t* address, void* arg);
+
+err_t dns_gethostbyname(const char* hostname, ip_addr_t* address, dns_found_callback found, void* arg);
+
+#endif // HOST_LWIP_DNS_H
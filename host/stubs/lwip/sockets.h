@@ -0,0 +1,24 @@
+/*
+  ANAVI Word Clock - Host build stand-in for lwIP sockets
+  TCP sockets that connect to the in-process MQTT broker, see HostSim.h.
+  Constants and structures come from the host headers.
+*/
+
+#ifndef HOST_LWIP_SOCKETS_H
+#define HOST_LWIP_SOCKETS_H
+
+#include <cerrno>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+
+int lwip_socket(int domain, int type, int protocol);
+int lwip_connect(int s, const struct sockaddr* name, socklen_t namelen);
+int lwip_select(int maxfdp1, fd_set* readset, fd_set* writeset, fd_set* exceptset,
+                struct timeval* timeout);
+int lwip_getsockopt(int s, int level, int optname, void* optval, socklen_t* optlen);
+int lwip_fcntl(int s, int cmd, int val);
+int lwip_close(int s);
+
+#endif // HOST_LWIP_SOCKETS_H
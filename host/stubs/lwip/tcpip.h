@@ -0,0 +1,15 @@
+/*
+  ANAVI Word Clock - Host build stand-in for the lwIP thread
+  There is no lwIP thread, callbacks run in the caller
+*/
+
+#ifndef HOST_LWIP_TCPIP_H
+#define HOST_LWIP_TCPIP_H
+
+#include "dns.h"
+
+typedef void (*tcpip_callback_fn)(void* ctx);
+
+err_t tcpip_callback(tcpip_callback_fn function, void* ctx);
+
+#endif // HOST_LWIP_TCPIP_H
@@ -0,0 +1,15 @@
+/*
+  ANAVI Word Clock - Host build stand-in for ESP-IDF nvs_flash
+*/
+
+#ifndef HOST_NVS_FLASH_H
+#define HOST_NVS_FLASH_H
+
+typedef int esp_err_t;
+
+#define ESP_OK   0
+#define ESP_FAIL -1
+
+esp_err_t nvs_flash_erase();
+
+#endif // HOST_NVS_FLASH_H
@@ -0,0 +1,175 @@
+/*
+  ANAVI Word Clock - LED Output Implementation
+  Double-buffered asynchronous WS2812B output through the RMT peripheral
+*/
+
+#include "led_output.h"
+
+#ifndef ARDUINO_ARCH_ESP32
+#include "HostSim.h"
+#endif
+
+// WS2812B bit timings in 100 ns RMT ticks
+#define RMT_TICK_HZ 10000000
+#define WS2812_T0H  4
+#define WS2812_T0L  8
+#define WS2812_T1H  8
+#define WS2812_T1L  4
+
+LedOutput::LedOutput(uint8_t pin, uint16_t numPixels)
+    : pin(pin)
+    , numBytes(min((uint16_t)LED_MAX_PIXELS, numPixels) * 3)
+    , front(0)
+    , scale(256)
+    , backPending(false)
+    , busy(false)
+    , doneAt(0)
+    , budgetSum(0)
+    , frontMa(0)
+    , backMa(0)
+    , peakMa(0)
+    , framesLimited(0)
+    , startedAt(0)
+    , frontSince(0)
+    , chargeMaUs(0)
+    #ifndef ARDUINO_ARCH_ESP32
+    , transferEndUs(0)
+    , transferUs(0)
+    #endif
+{
+    memset(buffers, 0, sizeof(buffers));
+    // Channel values, at full scale, that the budget leaves for after
+    // the idle draw of every LED
+    const uint32_t idleMa = (uint32_t)LED_IDLE_MA * (numBytes / 3);
+    if (LED_POWER_BUDGET_MA > idleMa)
+    {
+        budgetSum = (LED_POWER_BUDGET_MA - idleMa) * 255 / LED_CHANNEL_MA * 256;
+    }
+    frontMa = estimateMa(0);
+}
+
+void LedOutput::begin()
+{
+    #ifdef ARDUINO_ARCH_ESP32
+    if (!rmtInit(pin, RMT_TX_MODE, RMT_MEM_NUM_BLOCKS_1, RMT_TICK_HZ))
+    {
+        Serial.println("failed to initialize RMT for the LEDs");
+    }
+    #endif
+    doneAt = micros() - LED_RESET_US;
+    startedAt = micros();
+    frontSince = startedAt;
+}
+
+uint16_t LedOutput::estimateMa(uint32_t channelSum) const
+{
+    return LED_IDLE_MA * (numBytes / 3) + channelSum * LED_CHANNEL_MA / 255;
+}
+
+uint16_t LedOutput::getAverageMa() const
+{
+    const unsigned long now = micros();
+    const unsigned long elapsed = now - startedAt;
+    if (0 == elapsed)
+    {
+        return frontMa;
+    }
+    return (chargeMaUs + (uint64_t)frontMa * (now - frontSince)) / elapsed;
+}
+
+void LedOutput::submit(const uint8_t* pixels)
+{
+    uint16_t frameScale = scale;
+    #if LED_POWER_BUDGET_MA > 0
+    uint32_t rawSum = 0;
+    for (uint16_t i = 0; i < numBytes; i++)
+    {
+        rawSum += pixels[i];
+    }
+    if (rawSum * frameScale > budgetSum)
+    {
+        frameScale = budgetSum / rawSum;
+        framesLimited++;
+    }
+    #endif
+    uint8_t* back = buffers[front ^ 1];
+    uint32_t channelSum = 0;
+    for (uint16_t i = 0; i < numBytes; i++)
+    {
+        back[i] = (pixels[i] * frameScale) >> 8;
+        channelSum += back[i];
+    }
+    backMa = estimateMa(channelSum);
+    backPending = true;
+    service();
+}
+
+void LedOutput::service()
+{
+    if (busy && transferDone())
+    {
+        onTransferComplete();
+    }
+    // The LEDs latch after the line has been low for the reset time
+    if (!busy && backPending && (micros() - doneAt) >= LED_RESET_US)
+    {
+        front ^= 1;
+        backPending = false;
+        startTransfer();
+    }
+}
+
+void LedOutput::startTransfer()
+{
+    busy = true;
+
+    // The LEDs draw for the new frame from here on
+    const unsigned long now = micros();
+    chargeMaUs += (uint64_t)frontMa * (now - frontSince);
+    frontSince = now;
+    frontMa = backMa;
+    if (frontMa > peakMa)
+    {
+        peakMa = frontMa;
+    }
+
+    #ifdef ARDUINO_ARCH_ESP32
+    rmt_data_t* symbol = symbols;
+    for (uint16_t i = 0; i < numBytes; i++)
+    {
+        const uint8_t value = buffers[front][i];
+        for (uint8_t bit = 0x80; bit; bit >>= 1)
+        {
+            const bool one = value & bit;
+            symbol->level0 = 1;
+            symbol->duration0 = one ? WS2812_T1H : WS2812_T0H;
+            symbol->level1 = 0;
+            symbol->duration1 = one ? WS2812_T1L : WS2812_T0L;
+            symbol++;
+        }
+    }
+    rmtWriteAsync(pin, symbols, numBytes * 8);
+    #else
+    // 1.25 us per bit at 800 kHz
+    transferUs = numBytes * 10;
+    transferEndUs = micros() + transferUs;
+    #endif
+}
+
+bool LedOutput::transferDone()
+{
+    #ifdef ARDUINO_ARCH_ESP32
+    return rmtTransmitCompleted(pin);
+    #else
+    return (long)(micros() - transferEndUs) >= 0;
+    #endif
+}
+
+void LedOutput::onTransferComplete()
+{
+    busy = false;
+    doneAt = micros();
+    #ifndef ARDUINO_ARCH_ESP32
+    host::recordAsyncTransfer(transferUs);
+    #endif
+}
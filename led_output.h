@@ -0,0 +1,83 @@
+/*
+  ANAVI Word Clock - LED Output Header
+  Double-buffered asynchronous WS2812B output through the RMT peripheral
+*/
+
+#ifndef LED_OUTPUT_H
+#define LED_OUTPUT_H
+
+#include <Arduino.h>
+#include "config.h"
+
+#ifdef ARDUINO_ARCH_ESP32
+#include <esp32-hal-rmt.h>
+#endif
+
+class LedOutput {
+public:
+    // Constructor
+    LedOutput(uint8_t pin, uint16_t numPixels);
+
+    void begin();
+
+    // Scale applied while copying frames in, like Adafruit_NeoPixel's
+    // setBrightness() but without touching the caller's pixel buffer
+    void setBrightness(uint8_t level) { scale = (uint16_t)level + 1; }
+
+    // Queue a frame of wire-order pixel bytes (3 per pixel) and return at
+    // once. The frame goes out as soon as the wire is free; a frame still
+    // waiting is replaced by the newer one. A frame that would draw more
+    // than LED_POWER_BUDGET_MA is dimmed until it fits.
+    void submit(const uint8_t* pixels);
+
+    // Finish the transfer in flight and start the waiting frame, if any
+    void service();
+
+    // Estimated supply current of the LEDs: the frame on the wire, the
+    // highest and the time average since begin(), and the frames dimmed
+    // to stay within the budget
+    uint16_t getCurrentMa() const { return frontMa; }
+    uint16_t getPeakMa() const { return peakMa; }
+    uint16_t getAverageMa() const;
+    uint32_t getFramesLimited() const { return framesLimited; }
+
+private:
+    uint8_t pin;
+    uint16_t numBytes;
+
+    // buffers[front] is on the wire, the other one collects the next frame
+    uint8_t buffers[2][LED_MAX_PIXELS * 3];
+    uint8_t front;
+    uint16_t scale;
+    bool backPending;
+    bool busy;
+    unsigned long doneAt;
+
+    // Power model. The budget is kept as the largest sum of channel
+    // values times the brightness scale, so a frame costs one pass to
+    // sum and one multiply to check.
+    uint32_t budgetSum;
+    uint16_t frontMa;
+    uint16_t backMa;
+    uint16_t peakMa;
+    uint32_t framesLimited;
+    unsigned long startedAt;
+    unsigned long frontSince;
+    uint64_t chargeMaUs;
+
+    #ifdef ARDUINO_ARCH_ESP32
+    // One RMT symbol per bit of the front buffer
+    rmt_data_t symbols[LED_MAX_PIXELS * 24];
+    #else
+    // Host build: end of the modelled transfer on the simulated clock
+    unsigned long transferEndUs;
+    uint32_t transferUs;
+    #endif
+
+    void startTransfer();
+    bool transferDone();
+    void onTransferComplete();
+    uint16_t estimateMa(uint32_t channelSum) const;
+};
+
+#endif // LED_OUTPUT_H
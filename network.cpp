@@ -4,6 +4,10 @@
 */
 #include "network.h"
 #include "config.h"
+#include "perf.h"
+#include "config_parser.h"
+#include "config_store.h"
+#include "portal_assets.h"
 #include <WiFi.h>
 #include <ArduinoJson.h>
 #include <MD5Builder.h>
@@ -12,12 +16,95 @@
 #include <Arduino.h>
 // Initialize static instance pointer
 NetworkConnector* NetworkConnector::instance = nullptr;
+// Last UTC time seen, kept across software and watchdog resets (not a
+// power cycle) so the first frame does not wait for the network
+#define EPOCH_CACHE_MAGIC 0xA5C3D10CUL
+#ifdef ARDUINO_ARCH_ESP32
+#include <esp_attr.h>
+RTC_NOINIT_ATTR static uint32_t cachedEpoch;
+RTC_NOINIT_ATTR static uint32_t cachedEpochCheck;
+#else
+static uint32_t cachedEpoch;
+static uint32_t cachedEpochCheck;
+#endif
+// FNV-1a, evaluated at compile time for the command table
+static constexpr uint32_t topicHash(const char* text, uint32_t hash = 2166136261UL)
+{
+    return *text ? topicHash(text + 1, (hash ^ (uint8_t)*text) * 16777619UL) : hash;
+}
+// Topic suffixes, indexed by NetworkConnector::Topic
+static constexpr const char* TOPIC_SUFFIXES[] = {
+    "power",
+    "color",
+    "resethue",
+    "line1",
+    "line2",
+    "line3",
+    "tempcoef",
+    "tempformat",
+    "timezone",
+    "update",
+    "perf",
+    "state"
+};
+#define COMMAND_ROUTE(topic, handler) { topic, topicHash(TOPIC_SUFFIXES[topic]), handler }
+// Handlers for cmnd/<machineId>/<suffix>
+const NetworkConnector::CommandRoute NetworkConnector::commandRoutes[] = {
+    COMMAND_ROUTE(TOPIC_POWER, &NetworkConnector::processMessagePower),
+    COMMAND_ROUTE(TOPIC_COLOR, &NetworkConnector::processMessageColor),
+    COMMAND_ROUTE(TOPIC_TEMP_FORMAT, &NetworkConnector::processMessageScale),
+    COMMAND_ROUTE(TOPIC_TIMEZONE, &NetworkConnector::processMessageTimezone),
+    #ifdef OTA_UPGRADES
+    COMMAND_ROUTE(TOPIC_UPDATE, &NetworkConnector::do_ota_upgrade),
+    #endif
+    { TOPIC_COUNT, 0, nullptr }
+};
+// Command topics subscribed to on every new MQTT session
+const NetworkConnector::Topic NetworkConnector::subscribedTopics[] = {
+    TOPIC_POWER,
+    TOPIC_COLOR,
+    TOPIC_RESET_HUE,
+    TOPIC_LINE1,
+    TOPIC_LINE2,
+    TOPIC_LINE3,
+    TOPIC_TEMP_COEFFICIENT,
+    TOPIC_TEMP_FORMAT,
+    TOPIC_TIMEZONE,
+    #ifdef OTA_UPGRADES
+    TOPIC_UPDATE,
+    #endif
+};
 NetworkConnector::NetworkConnector()
-    : timeClient(ntpUDP, NTP_SERVER, NTP_OFFSET)
+    : timeSource(TIME_SOURCE_NONE)
+    , lastUtc(0)
+    , wifiLinkState(WIFI_LINK_OFF)
+    , wifiDeadline(0)
+    , factoryResetWindow(true)
+    , bootEpoch(0)
+    , bootEpochAt(0)
+    , firstFrameMs(0)
     , mqttClient(espClient)
+    , mqttLinkState(MQTT_LINK_OFF)
+    , mqttRetryAt(0)
+    , mqttFailures(0)
+    , stateDirty(0)
+    , stateDueAt(0)
+    , statePublishedAt(0)
+    , stateUptimeAt(0)
+    , lightOn(true)
+    , lightColor(0)
+    , shownBrightness(0)
+    , shownWordMask()
+    , shownWords(0)
+    , ledAverageMa(0)
+    , ledPeakMa(0)
+    , postedLightOn(true)
+    , postedLightColor(0)
+    , postedEpoch(0)
+    , postedLink(0)
     , configTempCelsius(true)
     , shouldSaveConfig(false)
-    , timezoneOffset(NTP_OFFSET)
+    , configStore(CONFIG_PATH, CONFIG_TEMP_PATH)
 {
     // Initialize configuration with defaults
     strcpy(mqtt_server, DEFAULT_MQTT_SERVER);
@@ -26,7 +113,7 @@ NetworkConnector::NetworkConnector()
     username[0] = '\0';
     password[0] = '\0';
     strcpy(temp_scale, DEFAULT_TEMP_SCALE);
-    strcpy(timezone, "+2");  // Default UTC+2 for Bulgaria
+    strcpy(timezone, DEFAULT_TIMEZONE);
     machineId[0] = '\0';
     #ifdef HOME_ASSISTANT_DISCOVERY
     ha_name[0] = '\0';
@@ -34,6 +121,8 @@ NetworkConnector::NetworkConnector()
     #ifdef OTA_UPGRADES
     ota_server[0] = '\0';
     #endif
+    sntp.setServers(NTP_SERVERS, sizeof(NTP_SERVERS) / sizeof(NTP_SERVERS[0]));
+    sntp.setPollRange(SNTP_POLL_MIN_S, SNTP_POLL_MAX_S);
     // Set static instance for callbacks
     instance = this;
 }
@@ -41,229 +130,431 @@ void NetworkConnector::begin()
 {
     // Calculate machine ID first
     calculateMachineId();
-    // Set MQTT topics
-    sprintf(cmnd_led1_power_topic, "cmnd/%s/power", machineId);
-    sprintf(cmnd_led1_color_topic, "cmnd/%s/color", machineId);
-    sprintf(cmnd_reset_hue_topic, "cmnd/%s/resethue", machineId);
-    sprintf(stat_led1_power_topic, "stat/%s/power", machineId);
-    sprintf(stat_led1_color_topic, "stat/%s/color", machineId);
-    sprintf(line1_topic, "cmnd/%s/line1", machineId);
-    sprintf(line2_topic, "cmnd/%s/line2", machineId);
-    sprintf(line3_topic, "cmnd/%s/line3", machineId);
-    sprintf(cmnd_temp_coefficient_topic, "cmnd/%s/tempcoef", machineId);
-    sprintf(stat_temp_coefficient_topic, "stat/%s/tempcoef", machineId);
-    sprintf(cmnd_temp_format, "cmnd/%s/tempformat", machineId);
-    #ifdef OTA_UPGRADES
-    sprintf(cmnd_update_topic, "cmnd/%s/update", machineId);
-    #endif
+    buildCommandTable();
     // Load configuration from file system
     loadConfig();
-    // Update timezone offset based on loaded config
-    updateTimezoneOffset();
-    // Wait for factory reset option
-    waitForFactoryReset();
-}
-void NetworkConnector::updateTimezoneOffset()
-{
-    // Convert timezone string (e.g., "+2" or "-5" or "5.5") to seconds
-    float hours = atof(timezone);
-    timezoneOffset = (long)(hours * 3600);
-    // Update NTP client with new offset
-    timeClient.setTimeOffset(timezoneOffset);
-    Serial.print("Timezone offset set to: ");
-    Serial.print(hours);
-    Serial.print(" hours (");
-    Serial.print(timezoneOffset);
-    Serial.println(" seconds)");
-}
-
-const char* NetworkConnector::buildTimezoneDropdown()
-{
-    static char dropdown[1600];
-    // Build a dropdown that updates a hidden field via onchange
-    strcpy(dropdown, "<br/><label>Timezone</label>");
-    strcat(dropdown, "<select id='tz' onchange=\"document.getElementById('timezone').value=this.value\">");
-    // Define timezone options
-    const char* options[][2] = {
-        {"-12", "UTC-12"},
-        {"-11", "UTC-11"},
-        {"-10", "UTC-10"},
-        {"-9", "UTC-9"},
-        {"-8", "UTC-8"},
-        {"-7", "UTC-7"},
-        {"-6", "UTC-6"},
-        {"-5", "UTC-5"},
-        {"-4", "UTC-4"},
-        {"-3", "UTC-3"},
-        {"-2", "UTC-2"},
-        {"-1", "UTC-1"},
-        {"0", "UTC+0"},
-        {"1", "UTC+1"},
-        {"2", "UTC+2"},
-        {"3", "UTC+3"},
-        {"4", "UTC+4"},
-        {"5", "UTC+5"},
-        {"5.5", "UTC+5:30"},
-        {"6", "UTC+6"},
-        {"7", "UTC+7"},
-        {"8", "UTC+8"},
-        {"9", "UTC+9"},
-        {"9.5", "UTC+9:30"},
-        {"10", "UTC+10"},
-        {"11", "UTC+11"},
-        {"12", "UTC+12"},
-        {"13", "UTC+13"},
-        {"14", "UTC+14"}
-    };
-    // Add each option
-    for (int i = 0; i < 29; i++) {
-        char opt[50];
-        if (strcmp(timezone, options[i][0]) == 0) {
-            sprintf(opt, "<option value='%s' selected>%s</option>", options[i][0], options[i][1]);
-        } else {
-            sprintf(opt, "<option value='%s'>%s</option>", options[i][0], options[i][1]);
+    // Rebuild the zone rule from the loaded config
+    applyTimezone();
+    // A reset keeps the last time seen, so the clock has something to
+    // show before the network is up
+    if (cachedEpochCheck == (cachedEpoch ^ EPOCH_CACHE_MAGIC))
+    {
+        bootEpoch = cachedEpoch;
+        bootEpochAt = millis();
+        Serial.println("Time cached before the reset is available");
+    }
+    #ifdef RTC_HOLDOVER
+    // After a power cycle the RTC has the time long before the network
+    rtc.begin();
+    #endif
+    selectTimeSource();
+    // The factory reset window is served by serviceFactoryReset()
+    Serial.println("Press button within 4 seconds for factory reset...");
+}
+void NetworkConnector::applyTimezone()
+{
+    TimeZone zone;
+    if (!zone.setRule(timezone, rulesDST))
+    {
+        Serial.print("Invalid timezone, keeping the previous one: ");
+        Serial.println(timezone);
+        return;
+    }
+    // Older firmware stored hours east of UTC and added the DST rules of
+    // the build. Keep the rule that made, so it no longer follows config.h.
+    char rule[sizeof(timezone)];
+    if (TimeZone::isPlainOffset(timezone) && zone.format(rule, sizeof(rule)))
+    {
+        Serial.print("Timezone ");
+        Serial.print(timezone);
+        Serial.print(" stored as ");
+        Serial.println(rule);
+        strcpy(timezone, rule);
+        requestSaveConfig();
+    }
+    timeZone = zone;
+    Serial.print("Timezone ");
+    Serial.print(timezone);
+    Serial.print(": UTC");
+    Serial.print(timeZone.getStdOffset() / 3600.0);
+    if (timeZone.hasDst())
+    {
+        Serial.print(", DST UTC");
+        Serial.print(timeZone.getDstOffset() / 3600.0);
+    }
+    Serial.println();
+}
+// Portal timezone choices as POSIX TZ rules, each zone with its own
+// daylight saving time or none
+struct TimezoneOption {
+    const char* value;
+    const char* label;
+};
+static constexpr TimezoneOption TIMEZONE_OPTIONS[] = {
+    { "<-12>12", "UTC-12" },
+    { "<-11>11", "UTC-11" },
+    { "<-10>10", "UTC-10" },
+    { "<-09>9", "UTC-9" },
+    { "AKST9AKDT,M3.2.0,M11.1.0", "UTC-9 with DST, Alaska" },
+    { "<-08>8", "UTC-8" },
+    { "PST8PDT,M3.2.0,M11.1.0", "UTC-8 with DST, US and Canada Pacific" },
+    { "<-07>7", "UTC-7" },
+    { "MST7MDT,M3.2.0,M11.1.0", "UTC-7 with DST, US and Canada Mountain" },
+    { "<-06>6", "UTC-6" },
+    { "CST6CDT,M3.2.0,M11.1.0", "UTC-6 with DST, US and Canada Central" },
+    { "<-05>5", "UTC-5" },
+    { "EST5EDT,M3.2.0,M11.1.0", "UTC-5 with DST, US and Canada Eastern" },
+    { "<-04>4", "UTC-4" },
+    { "AST4ADT,M3.2.0,M11.1.0", "UTC-4 with DST, Atlantic Canada" },
+    { "<-04>4<-03>,M9.1.6/24,M4.1.6/24", "UTC-4 with DST, Chile" },
+    { "NST3:30NDT,M3.2.0,M11.1.0", "UTC-3:30 with DST, Newfoundland" },
+    { "<-03>3", "UTC-3" },
+    { "<-02>2", "UTC-2" },
+    { "<-02>2<-01>,M3.5.0/-1,M10.5.0/0", "UTC-2 with DST, Greenland" },
+    { "<-01>1", "UTC-1" },
+    { "<-01>1<+00>,M3.5.0/0,M10.5.0/1", "UTC-1 with DST, Azores" },
+    { "<+00>0", "UTC+0" },
+    { "WET0WEST,M3.5.0/1,M10.5.0", "UTC+0 with DST, UK, Ireland, Portugal" },
+    { "<+01>-1", "UTC+1" },
+    { "CET-1CEST,M3.5.0,M10.5.0/3", "UTC+1 with DST, Central Europe" },
+    { "<+02>-2", "UTC+2" },
+    { "EET-2EEST,M3.5.0/3,M10.5.0/4", "UTC+2 with DST, Eastern Europe" },
+    { "IST-2IDT,M3.4.4/26,M10.5.0", "UTC+2 with DST, Israel" },
+    { "<+03>-3", "UTC+3" },
+    { "<+04>-4", "UTC+4" },
+    { "<+05>-5", "UTC+5" },
+    { "<+0530>-5:30", "UTC+5:30" },
+    { "<+06>-6", "UTC+6" },
+    { "<+07>-7", "UTC+7" },
+    { "<+08>-8", "UTC+8" },
+    { "<+09>-9", "UTC+9" },
+    { "<+0930>-9:30", "UTC+9:30" },
+    { "ACST-9:30ACDT,M10.1.0,M4.1.0/3", "UTC+9:30 with DST, South Australia" },
+    { "<+10>-10", "UTC+10" },
+    { "AEST-10AEDT,M10.1.0,M4.1.0/3", "UTC+10 with DST, South East Australia" },
+    { "<+11>-11", "UTC+11" },
+    { "<+12>-12", "UTC+12" },
+    { "NZST-12NZDT,M9.5.0,M4.1.0/3", "UTC+12 with DST, New Zealand" },
+    { "<+13>-13", "UTC+13" },
+    { "<+14>-14", "UTC+14" }
+};
+// Static portal fragments. The options, the machine ID and the script
+// that fills them in are fetched by the page from the routes added in
+// addPortalRoutes().
+static const char PORTAL_HEAD_HTML[] PROGMEM = "<script src='/portal.js' defer></script>";
+static const char PORTAL_TIMEZONE_HTML[] PROGMEM =
+    "<br/><label for='tz'>Timezone</label><select id='tz'></select>";
+static const char PORTAL_MACHINE_ID_HTML[] PROGMEM =
+    "<p style=\"color: red;\">Machine ID:</p><p><b id='mid'></b></p>"
+    "<p>Copy and save the machine ID because you will need it to control the device.</p>";
+void NetworkConnector::addPortalRoutes()
+{
+    WebServer& server = *wifiManager.server;
+    server.on("/portal.js", HTTP_GET, [this]() {
+        WebServer& server = *wifiManager.server;
+        server.sendHeader("Content-Encoding", "gzip");
+        server.sendHeader("Cache-Control", "max-age=86400");
+        server.send_P(200, PORTAL_JS_TYPE, (PGM_P)PORTAL_JS_GZ, sizeof(PORTAL_JS_GZ));
+    });
+    server.on("/portal/id", HTTP_GET, [this]() {
+        wifiManager.server->send(200, "text/plain", machineId);
+    });
+    server.on("/portal/tz", HTTP_GET, [this]() {
+        sendTimezoneOptions();
+    });
+}
+// Collects small writes into chunks of the chunked HTTP response
+class PortalChunker {
+public:
+    explicit PortalChunker(WebServer& server) : server(server), used(0) {}
+    ~PortalChunker() { flush(); }
+    void write(const char* text, size_t length)
+    {
+        while (length)
+        {
+            if (used == sizeof(chunk))
+            {
+                flush();
+            }
+            const size_t part = (length < sizeof(chunk) - used) ? length : sizeof(chunk) - used;
+            memcpy(chunk + used, text, part);
+            used += part;
+            text += part;
+            length -= part;
         }
-        strcat(dropdown, opt);
-    }
-    strcat(dropdown, "</select>");
-    return dropdown;
-}
-
-const char* NetworkConnector::buildTimezoneDetectJS()
-{
-    // Must be static so it survives after function returns
-    static const char js[] PROGMEM = R"rawliteral(
-<script>
-document.addEventListener("DOMContentLoaded", function () {
-  var tzSelect = document.getElementById("tz");
-  if (!tzSelect) return;
-
-  // Browser timezone offset in hours (can be fractional)
-  var offset = -new Date().getTimezoneOffset() / 60;
-
-  // Try exact match first
-  for (var i = 0; i < tzSelect.options.length; i++) {
-    if (tzSelect.options[i].value === offset.toString()) {
-      tzSelect.selectedIndex = i;
-      tzSelect.dispatchEvent(new Event("change"));
-      return;
-    }
-  }
-
-  // Fallback for floating point offsets (e.g. 5.5, 9.5)
-  for (var i = 0; i < tzSelect.options.length; i++) {
-    if (Math.abs(parseFloat(tzSelect.options[i].value) - offset) < 0.01) {
-      tzSelect.selectedIndex = i;
-      tzSelect.dispatchEvent(new Event("change"));
-      return;
-    }
-  }
-});
-</script>
-)rawliteral";
-
-    return js;
-}
-
-void NetworkConnector::setupWiFi()
+    }
+    void write(const char* text) { write(text, strlen(text)); }
+    // Text from the config, a POSIX rule may hold < and >, and a rule set
+    // over MQTT anything at all. Safe in text and quoted attributes.
+    void writeEscaped(const char* text)
+    {
+        for (; *text; text++)
+        {
+            if ('&' == *text)
+            {
+                write("&amp;");
+            }
+            else if ('<' == *text)
+            {
+                write("&lt;");
+            }
+            else if ('>' == *text)
+            {
+                write("&gt;");
+            }
+            else if ('\'' == *text)
+            {
+                write("&#39;");
+            }
+            else if ('"' == *text)
+            {
+                write("&quot;");
+            }
+            else
+            {
+                write(text, 1);
+            }
+        }
+    }
+    void flush()
+    {
+        if (used)
+        {
+            server.sendContent(chunk, used);
+            used = 0;
+        }
+    }
+private:
+    WebServer& server;
+    char chunk[PORTAL_CHUNK_SIZE];
+    size_t used;
+};
+void NetworkConnector::sendTimezoneOptions()
 {
-    // WiFiManager parameters
-
-    // Build and add timezone dropdown as custom HTML
-    WiFiManagerParameter custom_timezone_dropdown(buildTimezoneDropdown());
-
+    WebServer& server = *wifiManager.server;
+    server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+    server.send(200, "text/html", "");
+    {
+        PortalChunker out(server);
+        bool listed = false;
+        for (const TimezoneOption& option : TIMEZONE_OPTIONS)
+        {
+            listed = listed || 0 == strcmp(timezone, option.value);
+        }
+        if (!listed)
+        {
+            // A rule set over MQTT stays selectable as it is
+            out.write("<option data-rule selected value='");
+            out.writeEscaped(timezone);
+            out.write("'>");
+            out.writeEscaped(timezone);
+            out.write("</option>");
+        }
+        for (const TimezoneOption& option : TIMEZONE_OPTIONS)
+        {
+            // Offsets in seconds east of UTC, matched against the browser's
+            TimeZone zone;
+            zone.setRule(option.value);
+            char offsets[48];
+            snprintf(offsets, sizeof(offsets), "' data-std='%ld' data-dst='%ld",
+                     zone.getStdOffset(), zone.hasDst() ? zone.getDstOffset() : zone.getStdOffset());
+            out.write("<option value='");
+            out.writeEscaped(option.value);
+            out.write(offsets);
+            out.write(0 == strcmp(timezone, option.value) ? "' selected>" : "'>");
+            out.write(option.label);
+            out.write("</option>");
+        }
+    }
+    // Empty chunk, ends the response
+    server.sendContent("");
+}
+struct NetworkConnector::PortalParameters {
+    explicit PortalParameters(NetworkConnector& owner);
+    WiFiManagerParameter timezone_dropdown;
+    WiFiManagerParameter timezone;
+    WiFiManagerParameter mqtt_server;
+    WiFiManagerParameter mqtt_port;
+    WiFiManagerParameter workgroup;
+    WiFiManagerParameter mqtt_user;
+    WiFiManagerParameter mqtt_pass;
+    WiFiManagerParameter temperature_scale;
+    #ifdef HOME_ASSISTANT_DISCOVERY
+    WiFiManagerParameter mqtt_ha_name;
+    #endif
+    #ifdef OTA_UPGRADES
+    WiFiManagerParameter ota_server;
+    #endif
+    WiFiManagerParameter text_machine_id;
+};
+NetworkConnector::PortalParameters::PortalParameters(NetworkConnector& owner)
+    // The dropdown writes the chosen zone into the hidden field
+    : timezone_dropdown(PORTAL_TIMEZONE_HTML)
+    , timezone("timezone", "", owner.timezone, sizeof(owner.timezone), "type='hidden'")
     // Home Assistant and MQTT
-    WiFiManagerParameter custom_mqtt_server("server", "mqtt server", mqtt_server, sizeof(mqtt_server));
-    WiFiManagerParameter custom_mqtt_port("port", "mqtt port", mqtt_port, sizeof(mqtt_port));
-    WiFiManagerParameter custom_workgroup("workgroup", "workgroup", workgroup, sizeof(workgroup));
-    WiFiManagerParameter custom_mqtt_user("user", "MQTT username", username, sizeof(username));
-    WiFiManagerParameter custom_mqtt_pass("pass", "MQTT password", password, sizeof(password));
-    WiFiManagerParameter custom_temperature_scale("temp_scale", "Temperature scale", temp_scale, sizeof(temp_scale));
+    , mqtt_server("server", "mqtt server", owner.mqtt_server, sizeof(owner.mqtt_server))
+    , mqtt_port("port", "mqtt port", owner.mqtt_port, sizeof(owner.mqtt_port))
+    , workgroup("workgroup", "workgroup", owner.workgroup, sizeof(owner.workgroup))
+    , mqtt_user("user", "MQTT username", owner.username, sizeof(owner.username))
+    , mqtt_pass("pass", "MQTT password", owner.password, sizeof(owner.password))
+    , temperature_scale("temp_scale", "Temperature scale", owner.temp_scale, sizeof(owner.temp_scale))
     #ifdef HOME_ASSISTANT_DISCOVERY
-    WiFiManagerParameter custom_mqtt_ha_name("ha_name", "Device name for Home Assistant", ha_name, sizeof(ha_name));
+    , mqtt_ha_name("ha_name", "Device name for Home Assistant", owner.ha_name, sizeof(owner.ha_name))
     #endif
     #ifdef OTA_UPGRADES
-    WiFiManagerParameter custom_ota_server("ota_server", "OTA server", ota_server, sizeof(ota_server));
+    , ota_server("ota_server", "OTA server", owner.ota_server, sizeof(owner.ota_server))
     #endif
-    char htmlMachineId[200];
-    sprintf(htmlMachineId,"<p style=\"color: red;\">Machine ID:</p><p><b>%s</b></p><p>Copy and save the machine ID because you will need it to control the device.</p>", machineId);
-    WiFiManagerParameter custom_text_machine_id(htmlMachineId);
-    // WiFiManager setup
-    WiFiManager wifiManager;
+    , text_machine_id(PORTAL_MACHINE_ID_HTML)
+{
+}
+NetworkConnector::~NetworkConnector()
+{
+    // Out of line, PortalParameters is only complete in this file
+}
+void NetworkConnector::setupWiFi()
+{
+    // Returns at once: the stored credentials are tried in the background
+    // and the portal only opens when they are missing or do not work
+    wifiManager.setConfigPortalBlocking(false);
+    wifiManager.setConfigPortalTimeout(WIFI_CONFIG_TIMEOUT);
     wifiManager.setSaveConfigCallback(saveConfigCallbackWrapper);
-
-    wifiManager.setCustomHeadElement(buildTimezoneDetectJS());
-
+    wifiManager.setAPCallback(apWiFiCallbackWrapper);
+    wifiManager.setCustomHeadElement(PORTAL_HEAD_HTML);
+    wifiManager.setWebServerCallback([this]() { addPortalRoutes(); });
+    WiFi.mode(WIFI_STA);
+    if (wifiManager.getWiFiIsSaved())
+    {
+        connectWiFi();
+    }
+    else
+    {
+        startPortal();
+    }
+}
+void NetworkConnector::connectWiFi()
+{
+    Serial.println("Connecting to WiFi...");
+    WiFi.begin();
+    wifiLinkState = WIFI_LINK_CONNECTING;
+    wifiDeadline = millis() + WIFI_CONNECT_TIMEOUT_MS;
+}
+void NetworkConnector::startPortal()
+{
+    portal.reset(new PortalParameters(*this));
     // Add timezone dropdown
-    wifiManager.addParameter(&custom_timezone_dropdown);
+    wifiManager.addParameter(&portal->timezone_dropdown);
+    wifiManager.addParameter(&portal->timezone);
     // Add all other parameters
-    wifiManager.addParameter(&custom_mqtt_server);
-    wifiManager.addParameter(&custom_mqtt_port);
-    wifiManager.addParameter(&custom_workgroup);
-    wifiManager.addParameter(&custom_mqtt_user);
-    wifiManager.addParameter(&custom_mqtt_pass);
-    wifiManager.addParameter(&custom_temperature_scale);
+    wifiManager.addParameter(&portal->mqtt_server);
+    wifiManager.addParameter(&portal->mqtt_port);
+    wifiManager.addParameter(&portal->workgroup);
+    wifiManager.addParameter(&portal->mqtt_user);
+    wifiManager.addParameter(&portal->mqtt_pass);
+    wifiManager.addParameter(&portal->temperature_scale);
     #ifdef HOME_ASSISTANT_DISCOVERY
-    wifiManager.addParameter(&custom_mqtt_ha_name);
+    wifiManager.addParameter(&portal->mqtt_ha_name);
     #endif
     #ifdef OTA_UPGRADES
-    wifiManager.addParameter(&custom_ota_server);
+    wifiManager.addParameter(&portal->ota_server);
     #endif
-    wifiManager.addParameter(&custom_text_machine_id);
-    wifiManager.setTimeout(WIFI_CONFIG_TIMEOUT);
-    wifiManager.setAPCallback(apWiFiCallbackWrapper);
+    wifiManager.addParameter(&portal->text_machine_id);
     digitalWrite(pinAlarm, HIGH);
     // Create access point name
     String apId(machineId);
     apId = apId.substring(apId.length() - 5);
     String accessPointName = String(WIFI_AP_NAME_PREFIX) + apId;
-    if (!wifiManager.autoConnect(accessPointName.c_str(), ""))
+    wifiManager.startConfigPortal(accessPointName.c_str(), "");
+    wifiLinkState = WIFI_LINK_PORTAL;
+}
+void NetworkConnector::finishPortal()
+{
+    if (wifiManager.getConfigPortalActive())
     {
-        digitalWrite(pinAlarm, LOW);
-        Serial.println("failed to connect and hit timeout");
-        delay(3000);
+        wifiManager.stopConfigPortal();
     }
-    Serial.println("connected!)");
-    digitalWrite(pinAlarm, LOW);
     // Read updated parameters
-    strcpy(mqtt_server, custom_mqtt_server.getValue());
-    strcpy(mqtt_port, custom_mqtt_port.getValue());
-    strcpy(workgroup, custom_workgroup.getValue());
-    strcpy(username, custom_mqtt_user.getValue());
-    strcpy(password, custom_mqtt_pass.getValue());
-    // Get timezone from the form submission
-    // WiFiManager doesn't provide getValue() for custom HTML, so we need to read it differently
-    // The value will be in the POST data with name 'timezone'
-    if (shouldSaveConfig) {
-        // Timezone will be read from HTTP POST - WiFiManager handles this internally
-        // For now, keep existing value - we'll get it after save
-    }
-    strcpy(temp_scale, custom_temperature_scale.getValue());
+    snprintf(mqtt_server, sizeof(mqtt_server), "%s", portal->mqtt_server.getValue());
+    snprintf(mqtt_port, sizeof(mqtt_port), "%s", portal->mqtt_port.getValue());
+    snprintf(workgroup, sizeof(workgroup), "%s", portal->workgroup.getValue());
+    snprintf(username, sizeof(username), "%s", portal->mqtt_user.getValue());
+    snprintf(password, sizeof(password), "%s", portal->mqtt_pass.getValue());
+    // The dropdown fills in the hidden timezone field
+    if ('\0' != portal->timezone.getValue()[0])
+    {
+        snprintf(timezone, sizeof(timezone), "%s", portal->timezone.getValue());
+    }
+    snprintf(temp_scale, sizeof(temp_scale), "%s", portal->temperature_scale.getValue());
     #ifdef HOME_ASSISTANT_DISCOVERY
-    strcpy(ha_name, custom_mqtt_ha_name.getValue());
+    snprintf(ha_name, sizeof(ha_name), "%s", portal->mqtt_ha_name.getValue());
     #endif
     #ifdef OTA_UPGRADES
-    strcpy(ota_server, custom_ota_server.getValue());
+    snprintf(ota_server, sizeof(ota_server), "%s", portal->ota_server.getValue());
     #endif
-    // Update timezone offset based on new value
-    updateTimezoneOffset();
+    portal.reset();
+    // Rebuild the zone rule from the new value
+    applyTimezone();
     // Save config if needed
     if (shouldSaveConfig)
     {
         saveConfig();
     }
+}
+void NetworkConnector::onWiFiConnected()
+{
+    Serial.println("connected!)");
+    digitalWrite(pinAlarm, LOW);
     Serial.println("local ip");
     Serial.println(WiFi.localIP());
-    // Start NTP client
-    timeClient.begin();
-    timeClient.update();
+    wifiLinkState = WIFI_LINK_ONLINE;
+    // Poll the SNTP servers now, the NTP tick takes it from here
+    sntp.begin();
+    updateTime();
+}
+void NetworkConnector::serviceWiFi()
+{
+    switch (wifiLinkState)
+    {
+        case WIFI_LINK_CONNECTING:
+            if (WL_CONNECTED == WiFi.status())
+            {
+                onWiFiConnected();
+            }
+            else if ((long)(millis() - wifiDeadline) >= 0)
+            {
+                Serial.println("WiFi connection timed out");
+                startPortal();
+            }
+            break;
+        case WIFI_LINK_PORTAL:
+            if (wifiManager.process() || WL_CONNECTED == WiFi.status())
+            {
+                finishPortal();
+                onWiFiConnected();
+            }
+            else if (!wifiManager.getConfigPortalActive())
+            {
+                digitalWrite(pinAlarm, LOW);
+                Serial.println("failed to connect and hit timeout");
+                portal.reset();
+                connectWiFi();
+            }
+            break;
+        case WIFI_LINK_ONLINE:
+        case WIFI_LINK_OFF:
+            // Once associated, the WiFi driver reconnects on its own
+            break;
+    }
 }
 void NetworkConnector::setupMQTT()
 {
     const int mqttPort = atoi(mqtt_port);
     mqttClient.setServer(mqtt_server, mqttPort);
     mqttClient.setCallback(mqttCallbackWrapper);
-    mqttReconnect();
+    mqttClient.setKeepAlive(MQTT_KEEPALIVE);
+    mqttClient.setSocketTimeout(MQTT_SOCKET_TIMEOUT);
+    // The first attempt happens from loop(), setup() does not wait for it
+    mqttLinkState = MQTT_LINK_BACKOFF;
+    mqttRetryAt = millis();
 }
 void NetworkConnector::printConfiguration()
 {
@@ -292,11 +583,16 @@ void NetworkConnector::printConfiguration()
     configTempCelsius = String(temp_scale).equalsIgnoreCase("celsius");
     Serial.print("Temperature scale: ");
     Serial.println(configTempCelsius ? "Celsius" : "Fahrenheit");
-    Serial.print("Timezone: UTC");
+    Serial.print("Timezone: ");
     Serial.print(timezone);
-    Serial.print(" (");
-    Serial.print(timezoneOffset / 3600.0);
-    Serial.println(" hours)");
+    Serial.print(" (UTC");
+    Serial.print(timeZone.getStdOffset() / 3600.0);
+    if (timeZone.hasDst())
+    {
+        Serial.print(", DST UTC");
+        Serial.print(timeZone.getDstOffset() / 3600.0);
+    }
+    Serial.println(")");
     #ifdef HOME_ASSISTANT_DISCOVERY
     Serial.print("Home Assistant device name: ");
     Serial.println(ha_name);
@@ -314,33 +610,197 @@ void NetworkConnector::printConfiguration()
     #endif
     Serial.println("");
 }
+void NetworkConnector::loop()
+{
+    DisplayReport report;
+    while (displayReports.pop(report))
+    {
+        applyDisplayReport(report);
+    }
+    serviceWiFi();
+    if (configStore.isSaveDue(millis()))
+    {
+        saveConfig();
+    }
+    switch (mqttLinkState)
+    {
+        case MQTT_LINK_ONLINE:
+            // Also sends the keepalive ping when it is due
+            if (mqttClient.loop())
+            {
+                serviceState();
+                return;
+            }
+            Serial.print("MQTT connection lost, rc=");
+            Serial.println(mqttClient.state());
+            mqttFailures = 0;
+            mqttScheduleRetry();
+            break;
+        case MQTT_LINK_BACKOFF:
+            // Without WiFi there is nothing to retry against yet
+            if ((long)(millis() - mqttRetryAt) < 0 || WL_CONNECTED != WiFi.status())
+            {
+                return;
+            }
+            Serial.print("Attempting MQTT connection to ");
+            Serial.println(mqtt_server);
+            mqttTransport.begin(mqtt_server, atoi(mqtt_port), MQTT_CONNECT_TIMEOUT_MS);
+            mqttLinkState = MQTT_LINK_CONNECTING;
+            break;
+        case MQTT_LINK_CONNECTING:
+            switch (mqttTransport.poll())
+            {
+                case TcpConnector::TCP_RESOLVING:
+                case TcpConnector::TCP_CONNECTING:
+                    return;
+                case TcpConnector::TCP_CONNECTED:
+                    // PubSubClient skips its own connect for a connected
+                    // client and only exchanges CONNECT and CONNACK
+                    espClient = WiFiClient(mqttTransport.release());
+                    if (mqttConnect())
+                    {
+                        return;
+                    }
+                    break;
+                default:
+                    Serial.println("MQTT broker not reachable");
+                    break;
+            }
+            mqttScheduleRetry();
+            break;
+        case MQTT_LINK_OFF:
+            break;
+    }
+}
 void NetworkConnector::updateTime()
 {
-    timeClient.update();
+    PERF_PROBE(PERF_UPDATE_TIME);
+    sntp.service();
+    #ifdef RTC_HOLDOVER
+    rtc.service(sntp);
+    #endif
+    selectTimeSource();
+    serviceDisplay();
 }
-unsigned long NetworkConnector::getEpochTime()
+#ifdef PERF_PROBES
+void NetworkConnector::publishPerf()
 {
-    return timeClient.getEpochTime();
+    char payload[PERF_PAYLOAD_SIZE];
+    const size_t length = perfSummary(payload, sizeof(payload));
+    // Streamed, so the payload is not bound by the PubSubClient buffer
+    if (mqttClient.beginPublish(buildTopic(TOPIC_STAT, TOPIC_PERF), length, false))
+    {
+        mqttClient.write((const uint8_t*)payload, length);
+        mqttClient.endPublish();
+    }
 }
-void NetworkConnector::waitForFactoryReset()
+#endif
+void NetworkConnector::selectTimeSource()
 {
-    Serial.println("Press button within 4 seconds for factory reset...");
-    for (int iter = 0; iter < FACTORY_RESET_WAIT_ITERATIONS; iter++)
+    // Whichever source has the smaller error bound has authority
+    TimeSource best = TIME_SOURCE_NONE;
+    uint32_t bestError = UINT32_MAX;
+    if (sntp.isSynchronized())
+    {
+        best = TIME_SOURCE_SNTP;
+        bestError = sntp.getErrorUs() / 1000;
+    }
+    #ifdef RTC_HOLDOVER
+    if (rtc.isValid() && rtc.getErrorMs() < bestError)
+    {
+        best = TIME_SOURCE_RTC;
+        bestError = rtc.getErrorMs();
+    }
+    #endif
+    if (TIME_SOURCE_NONE == best && 0 != bootEpoch)
+    {
+        best = TIME_SOURCE_CACHE;
+    }
+    if (best != timeSource)
     {
-        digitalWrite(pinAlarm, HIGH);
-        delay(FACTORY_RESET_BLINK_DELAY);
-        if (false == digitalRead(pinButton))
+        static const char* const names[] = { "none", "cache", "RTC", "SNTP" };
+        Serial.print("Time source: ");
+        Serial.print(names[best]);
+        if (UINT32_MAX != bestError)
         {
-            factoryReset();
-            return;
+            Serial.print(", error within ");
+            Serial.print(bestError);
+            Serial.print(" ms");
         }
-        digitalWrite(pinAlarm, LOW);
-        delay(FACTORY_RESET_BLINK_DELAY);
-        if (false == digitalRead(pinButton))
+        Serial.println();
+        timeSource = best;
+        markStateDirty(STATE_TIME);
+    }
+}
+uint32_t NetworkConnector::getTimeErrorMs() const
+{
+    switch (timeSource)
+    {
+        case TIME_SOURCE_SNTP:
+            return sntp.getErrorUs() / 1000;
+        #ifdef RTC_HOLDOVER
+        case TIME_SOURCE_RTC:
+            return rtc.getErrorMs();
+        #endif
+        default:
+            return UINT32_MAX;
+    }
+}
+unsigned long NetworkConnector::getEpochTime()
+{
+    uint32_t utc;
+    switch (timeSource)
+    {
+        case TIME_SOURCE_SNTP:
+            utc = sntp.now();
+            break;
+        #ifdef RTC_HOLDOVER
+        case TIME_SOURCE_RTC:
+            utc = rtc.now();
+            break;
+        #endif
+        case TIME_SOURCE_CACHE:
+            utc = bootEpoch + (millis() - bootEpochAt) / 1000;
+            break;
+        default:
+            return 0;
+    }
+    // A source change may land a second or two behind the last time
+    // shown; hold it until the new source catches up
+    if (utc < lastUtc && lastUtc - utc <= TIME_HOLD_MAX_S)
+    {
+        utc = lastUtc;
+    }
+    lastUtc = utc;
+    if (TIME_SOURCE_CACHE != timeSource)
+    {
+        cachedEpoch = utc;
+        cachedEpochCheck = cachedEpoch ^ EPOCH_CACHE_MAGIC;
+    }
+    return timeZone.toLocal(utc);
+}
+void NetworkConnector::serviceFactoryReset(bool buttonPressed)
+{
+    if (!factoryResetWindow)
+    {
+        return;
+    }
+    const unsigned long now = millis();
+    if (now >= FACTORY_RESET_WINDOW_MS)
+    {
+        factoryResetWindow = false;
+        if (WIFI_LINK_PORTAL != wifiLinkState)
         {
-            factoryReset();
-            return;
+            digitalWrite(pinAlarm, LOW);
         }
+        return;
+    }
+    digitalWrite(pinAlarm, ((now / FACTORY_RESET_BLINK_DELAY) & 1) ? LOW : HIGH);
+    if (buttonPressed)
+    {
+        factoryResetWindow = false;
+        // Blocks only while the button is held down to confirm
+        factoryReset();
     }
 }
 void NetworkConnector::factoryReset()
@@ -391,45 +851,182 @@ void NetworkConnector::factoryReset()
         }
     }
 }
-void NetworkConnector::processMessageScale(const char* text)
+void NetworkConnector::processMessageScale(const byte* payload, unsigned int length)
 {
     StaticJsonDocument<JSON_SCALE_SIZE> data;
-    deserializeJson(data, text);
+    deserializeJson(data, payload, length);
+    const bool celsius = data.containsKey("scale") && (0 == strcmp(data["scale"], "celsius"));
     Serial.print("Changing the temperature scale to: ");
-    if (data.containsKey("scale") && (0 == strcmp(data["scale"], "celsius")) )
+    Serial.println(celsius ? "Celsius" : "Fahrenheit");
+    if (celsius == configTempCelsius)
     {
-        Serial.println("Celsius");
-        configTempCelsius = true;
-        strcpy(temp_scale, "celsius");
+        return;
+    }
+    configTempCelsius = celsius;
+    strcpy(temp_scale, celsius ? "celsius" : "fahrenheit");
+    markStateDirty(STATE_TEMP_SCALE);
+    requestSaveConfig();
+}
+void NetworkConnector::processMessageTimezone(const byte* payload, unsigned int length)
+{
+    // A POSIX TZ rule such as CET-1CEST,M3.5.0,M10.5.0/3, or hours east
+    // of UTC such as +2, which is stored as a rule with the DST preset of
+    // the build
+    char rule[sizeof(timezone)];
+    if (0 == length || length >= sizeof(rule))
+    {
+        Serial.println("Timezone rejected: empty or too long");
+        return;
+    }
+    memcpy(rule, payload, length);
+    rule[length] = '\0';
+    if (0 == strcmp(rule, timezone))
+    {
+        return;
+    }
+    TimeZone zone;
+    if (!zone.setRule(rule, rulesDST))
+    {
+        Serial.print("Timezone rejected: ");
+        Serial.println(rule);
+        return;
+    }
+    strcpy(timezone, rule);
+    applyTimezone();
+    markStateDirty(STATE_TIME);
+    requestSaveConfig();
+}
+void NetworkConnector::processMessagePower(const byte* payload, unsigned int length)
+{
+    // Plain ON, OFF or TOGGLE
+    bool on = lightOn;
+    if (2 == length && 0 == strncasecmp((const char*)payload, "ON", length))
+    {
+        on = true;
+    }
+    else if (3 == length && 0 == strncasecmp((const char*)payload, "OFF", length))
+    {
+        on = false;
+    }
+    else if (6 == length && 0 == strncasecmp((const char*)payload, "TOGGLE", length))
+    {
+        on = !lightOn;
+    }
+    Serial.print("Power: ");
+    Serial.println(on ? "ON" : "OFF");
+    if (on != lightOn)
+    {
+        lightOn = on;
+        markStateDirty(STATE_POWER);
+        serviceDisplay();
+    }
+}
+void NetworkConnector::processMessageColor(const byte* payload, unsigned int length)
+{
+    // #RRGGBB for a fixed color, anything else returns to the rainbow
+    uint32_t color = 0;
+    if (7 == length && '#' == payload[0])
+    {
+        char hex[7];
+        memcpy(hex, payload + 1, 6);
+        hex[6] = '\0';
+        color = strtoul(hex, nullptr, 16);
+    }
+    Serial.print("Color: ");
+    if (color)
+    {
+        Serial.println(color, HEX);
     }
     else
     {
-        Serial.println("Fahrenheit");
-        configTempCelsius = false;
-        strcpy(temp_scale, "fahrenheit");
+        Serial.println("rainbow");
+    }
+    if (color != lightColor)
+    {
+        lightColor = color;
+        markStateDirty(STATE_COLOR);
+        serviceDisplay();
     }
-    saveConfig();
+}
+const char* NetworkConnector::buildTopic(TopicNamespace ns, const char* suffix)
+{
+    const char* root = (TOPIC_CMND == ns) ? "cmnd" : (TOPIC_STAT == ns) ? "stat" : workgroup;
+    snprintf(topicScratch, sizeof(topicScratch), "%s/%s/%s", root, machineId, suffix);
+    return topicScratch;
+}
+const char* NetworkConnector::buildTopic(TopicNamespace ns, Topic topic)
+{
+    static_assert(sizeof(TOPIC_SUFFIXES) / sizeof(TOPIC_SUFFIXES[0]) == TOPIC_COUNT,
+                  "TOPIC_SUFFIXES out of sync with NetworkConnector::Topic");
+    return buildTopic(ns, TOPIC_SUFFIXES[topic]);
+}
+const char* NetworkConnector::matchTopic(const char* topic, TopicNamespace ns) const
+{
+    // Walk <root>/<machineId>/ in place and return the suffix, if any
+    const char* root = (TOPIC_CMND == ns) ? "cmnd" : (TOPIC_STAT == ns) ? "stat" : workgroup;
+    const size_t rootLength = strlen(root);
+    const size_t idLength = strlen(machineId);
+    if (0 != strncmp(topic, root, rootLength) || '/' != topic[rootLength])
+    {
+        return nullptr;
+    }
+    topic += rootLength + 1;
+    if (0 != strncmp(topic, machineId, idLength) || '/' != topic[idLength])
+    {
+        return nullptr;
+    }
+    return topic + idLength + 1;
+}
+void NetworkConnector::buildCommandTable()
+{
+    memset(commandSlots, 0, sizeof(commandSlots));
+    for (const CommandRoute* route = commandRoutes; route->handler; route++)
+    {
+        // Open addressing with linear probing
+        uint8_t slot = route->hash & (COMMAND_SLOTS - 1);
+        while (commandSlots[slot])
+        {
+            slot = (slot + 1) & (COMMAND_SLOTS - 1);
+        }
+        commandSlots[slot] = route;
+    }
+}
+const NetworkConnector::CommandRoute* NetworkConnector::findCommand(const char* suffix) const
+{
+    const uint32_t hash = topicHash(suffix);
+    for (uint8_t probe = 0; probe < COMMAND_SLOTS; probe++)
+    {
+        const CommandRoute* route = commandSlots[(hash + probe) & (COMMAND_SLOTS - 1)];
+        if (!route)
+        {
+            return nullptr;
+        }
+        // One full compare guards against hash collisions
+        if (route->hash == hash && 0 == strcmp(TOPIC_SUFFIXES[route->topic], suffix))
+        {
+            return route;
+        }
+    }
+    return nullptr;
 }
 void NetworkConnector::mqttCallback(char* topic, byte* payload, unsigned int length)
 {
-    char text[length + 1];
-    snprintf(text, length + 1, "%s", payload);
     Serial.print("Message arrived [");
     Serial.print(topic);
     Serial.print("] ");
-    Serial.println(text);
-    if (strcmp(topic, cmnd_temp_format) == 0)
+    Serial.write(payload, length);
+    Serial.println();
+    const char* suffix = matchTopic(topic, TOPIC_CMND);
+    if (!suffix)
     {
-        processMessageScale(text);
+        return;
     }
-    #ifdef OTA_UPGRADES
-    if (strcmp(topic, cmnd_update_topic) == 0)
+    const CommandRoute* route = findCommand(suffix);
+    if (route)
     {
-        Serial.println("OTA request seen.\n");
-        do_ota_upgrade(text);
-        return;
+        // The payload is not NUL-terminated, handlers must honor length
+        (this->*route->handler)(payload, length);
     }
-    #endif
 }
 void NetworkConnector::mqttCallbackWrapper(char* topic, byte* payload, unsigned int length)
 {
@@ -449,46 +1046,194 @@ void NetworkConnector::calculateMachineId()
     md5.calculate();
     md5.toString().toCharArray(machineId, 33);
 }
-void NetworkConnector::mqttReconnect()
+bool NetworkConnector::mqttConnect()
 {
     char clientId[51];
     snprintf(clientId, sizeof(clientId), "anavi-word-clock-%s", machineId);
-    for (int attempt = 0; attempt < MQTT_RECONNECT_ATTEMPTS; ++attempt)
+    if (false == mqttClient.connect(clientId, username, password))
+    {
+        Serial.print("MQTT connection failed, rc=");
+        Serial.println(mqttClient.state());
+        return false;
+    }
+    Serial.println("MQTT connected");
+    mqttLinkState = MQTT_LINK_ONLINE;
+    mqttFailures = 0;
+    // A new session has no subscriptions, restore them
+    mqttSubscribe();
+    #ifdef HOME_ASSISTANT_DISCOVERY
+    publishDiscoveryState();
+    #endif
+    publishState();
+    return true;
+}
+void NetworkConnector::mqttSubscribe()
+{
+    for (const Topic topic : subscribedTopics)
+    {
+        mqttClient.subscribe(buildTopic(TOPIC_CMND, topic));
+    }
+}
+void NetworkConnector::mqttScheduleRetry()
+{
+    // Exponential backoff with equal jitter, so a fleet that lost the same
+    // broker does not reconnect in lockstep
+    const uint8_t shift = min(mqttFailures, (uint8_t)16);
+    const unsigned long backoff = min((unsigned long)MQTT_BACKOFF_MAX_MS,
+                                      (unsigned long)MQTT_BACKOFF_MIN_MS << shift);
+    const unsigned long wait = backoff / 2 + random(backoff / 2 + 1);
+    if (mqttFailures < 255)
     {
-        Serial.print("Attempting MQTT connection...");
-        if (true == mqttClient.connect(clientId, username, password))
+        mqttFailures++;
+    }
+    mqttLinkState = MQTT_LINK_BACKOFF;
+    mqttRetryAt = millis() + wait;
+    Serial.print("Next MQTT attempt in ");
+    Serial.print(wait);
+    Serial.println(" ms");
+}
+bool NetworkConnector::postDisplayCommand(DisplayCommand::Type type, uint32_t value)
+{
+    const DisplayCommand command = { type, value, micros() };
+    return displayCommands.push(command);
+}
+void NetworkConnector::serviceDisplay()
+{
+    // Only changes are sent; whatever the full queue turned away goes
+    // again on the next pass
+    if (lightOn != postedLightOn && postDisplayCommand(DisplayCommand::POWER, lightOn))
+    {
+        postedLightOn = lightOn;
+    }
+    if (lightColor != postedLightColor && postDisplayCommand(DisplayCommand::COLOR, lightColor))
+    {
+        postedLightColor = lightColor;
+    }
+    uint8_t link = isWiFiConnected() ? DISPLAY_LINK_WIFI : 0;
+    if (hasTime())
+    {
+        // Sent as the second turns over, the renderer counts on from there
+        const uint32_t local = getEpochTime();
+        if (local != postedEpoch && postDisplayCommand(DisplayCommand::TIME, local))
         {
-            Serial.println("connected");
-            // Subscribe to topics
-            mqttClient.subscribe(cmnd_led1_power_topic);
-            mqttClient.subscribe(cmnd_led1_color_topic);
-            mqttClient.subscribe(cmnd_reset_hue_topic);
-            mqttClient.subscribe(line1_topic);
-            mqttClient.subscribe(line2_topic);
-            mqttClient.subscribe(line3_topic);
-            mqttClient.subscribe(cmnd_temp_coefficient_topic);
-            mqttClient.subscribe(cmnd_temp_format);
-            #ifdef OTA_UPGRADES
-            mqttClient.subscribe(cmnd_update_topic);
-            #endif
-            #ifdef HOME_ASSISTANT_DISCOVERY
-            publishDiscoveryState();
-            #endif
-            publishState();
-            break;
+            postedEpoch = local;
         }
-        else
+        if (0 != postedEpoch)
+        {
+            link |= DISPLAY_LINK_TIME;
+        }
+    }
+    if (link != postedLink && postDisplayCommand(DisplayCommand::LINK, link))
+    {
+        postedLink = link;
+    }
+}
+void NetworkConnector::applyDisplayReport(const DisplayReport& report)
+{
+    uint8_t fields = 0;
+    shownWords = report.words < LED_MASK_WORDS ? report.words : LED_MASK_WORDS;
+    for (uint8_t w = 0; w < shownWords; w++)
+    {
+        if (report.wordMask[w] != shownWordMask[w])
+        {
+            shownWordMask[w] = report.wordMask[w];
+            fields |= STATE_WORD_MASK;
+        }
+    }
+    if (report.brightness != shownBrightness)
+    {
+        shownBrightness = report.brightness;
+        fields |= STATE_BRIGHTNESS;
+    }
+    if (report.firstFrameMs && !firstFrameMs)
+    {
+        // Published once with the state document
+        firstFrameMs = report.firstFrameMs;
+        fields |= STATE_BOOT;
+    }
+    // The power estimate rides along with the next state document
+    ledAverageMa = report.averageMa;
+    ledPeakMa = report.peakMa;
+    if (fields)
+    {
+        markStateDirty(fields);
+    }
+}
+void NetworkConnector::markStateDirty(uint8_t fields)
+{
+    if (0 == stateDirty)
+    {
+        // The first change opens the coalescing window, and the rate limit
+        // may push it further out. A brightness ramp or a burst of
+        // commands then goes out as a single message.
+        const unsigned long now = millis();
+        stateDueAt = now + STATE_COALESCE_MS;
+        const unsigned long allowedAt = statePublishedAt + STATE_MIN_INTERVAL_MS;
+        if (0 != statePublishedAt && (long)(allowedAt - stateDueAt) > 0)
         {
-            Serial.print("failed, rc=");
-            Serial.print(mqttClient.state());
-            Serial.println(" try again in 5 seconds");
-            delay(MQTT_RECONNECT_DELAY);
+            stateDueAt = allowedAt;
         }
     }
+    stateDirty |= fields;
+}
+void NetworkConnector::serviceState()
+{
+    const unsigned long now = millis();
+    if ((long)(now - stateUptimeAt) >= 0)
+    {
+        stateUptimeAt = now + STATE_UPTIME_MS;
+        markStateDirty(STATE_UPTIME);
+    }
+    if (0 != stateDirty && (long)(now - stateDueAt) >= 0)
+    {
+        publishState();
+    }
 }
 void NetworkConnector::publishState()
 {
-    //TODO
+    // The retained document always carries every field, the dirty set
+    // only decides when it is worth sending
+    StaticJsonDocument<JSON_STATE_SIZE> json;
+    json["power"] = lightOn ? "ON" : "OFF";
+    char color[10];
+    if (lightColor)
+    {
+        snprintf(color, sizeof(color), "#%06lX", (unsigned long)lightColor);
+        json["color"] = color;
+    }
+    else
+    {
+        json["color"] = "rainbow";
+    }
+    json["brightness"] = shownBrightness;
+    json["temp_scale"] = temp_scale;
+    char words[LED_MASK_WORDS * 16 + 1] = "";
+    for (uint8_t w = 0; w < shownWords; w++)
+    {
+        snprintf(words + w * 16, sizeof(words) - w * 16, "%08lX%08lX",
+                 (unsigned long)(shownWordMask[w] >> 32), (unsigned long)(uint32_t)shownWordMask[w]);
+    }
+    json["words"] = words;
+    json["led_ma"] = ledAverageMa;
+    json["led_peak_ma"] = ledPeakMa;
+    json["uptime"] = millis() / 1000;
+    if (firstFrameMs)
+    {
+        json["boot_ms"] = firstFrameMs;
+    }
+    static const char* const sources[] = { "none", "cache", "rtc", "ntp" };
+    json["time_source"] = sources[timeSource];
+    json["timezone"] = timezone;
+    const uint32_t timeError = getTimeErrorMs();
+    if (UINT32_MAX != timeError)
+    {
+        json["time_error_ms"] = timeError;
+    }
+    char payload[JSON_STATE_SIZE];
+    const size_t length = serializeJson(json, payload, sizeof(payload));
+    mqttClient.publish(buildTopic(TOPIC_STAT, TOPIC_STATE), (const uint8_t*)payload, length, true);
+    stateDirty = 0;
+    statePublishedAt = millis();
 }
 void NetworkConnector::publishSensorData(const char* subTopic, const char* key, const float value)
 {
@@ -496,9 +1241,7 @@ void NetworkConnector::publishSensorData(const char* subTopic, const char* key,
     json[key] = value;
     char payload[JSON_SMALL_SIZE];
     serializeJson(json, payload);
-    char topic[TOPIC_BUFFER_SIZE];
-    sprintf(topic,"%s/%s/%s", workgroup, machineId, subTopic);
-    mqttClient.publish(topic, payload, true);
+    mqttClient.publish(buildTopic(TOPIC_WORKGROUP, subTopic), payload, true);
 }
 void NetworkConnector::publishSensorData(const char* subTopic, const char* key, const String& value)
 {
@@ -506,9 +1249,7 @@ void NetworkConnector::publishSensorData(const char* subTopic, const char* key,
     json[key] = value;
     char payload[JSON_SMALL_SIZE];
     serializeJson(json, payload);
-    char topic[TOPIC_BUFFER_SIZE];
-    sprintf(topic,"%s/%s/%s", workgroup, machineId, subTopic);
-    mqttClient.publish(topic, payload, true);
+    mqttClient.publish(buildTopic(TOPIC_WORKGROUP, subTopic), payload, true);
 }
 float NetworkConnector::convertCelsiusToFahrenheit(float temperature)
 {
@@ -550,66 +1291,109 @@ void NetworkConnector::apWiFiCallbackWrapper(WiFiManager *myWiFiManager)
 }
 void NetworkConnector::loadConfig()
 {
-    Serial.println("mounting FS...");
-    if (SPIFFS.begin(true))
+    const unsigned long started = micros();
+    ConfigRecord record;
+    if (configStore.load(record))
+    {
+        unpackConfig(record);
+        Serial.print("config loaded from NVS in ");
+        Serial.print(micros() - started);
+        Serial.println(" us");
+        return;
+    }
+    // First boot with this firmware, or a layout change: take over the
+    // JSON export and store it as a record for the next boot
+    migrateConfig();
+    packConfig(record);
+    configStore.save(record);
+}
+void NetworkConnector::migrateConfig()
+{
+    // Missing keys keep the defaults
+    #ifdef HOME_ASSISTANT_DISCOVERY
+    snprintf(ha_name, sizeof(ha_name), "%s", machineId);
+    #endif
+    // Never format here, an unreadable file system only means defaults
+    if (!configStore.mountFileSystem(false))
+    {
+        return;
+    }
+    configStore.recover();
+    if (SPIFFS.exists(CONFIG_PATH))
     {
-        Serial.println("mounted file system");
-        if (SPIFFS.exists("/config.json"))
+        Serial.println("reading config file");
+        File configFile = SPIFFS.open(CONFIG_PATH, "r");
+        if (configFile)
         {
-            Serial.println("reading config file");
-            File configFile = SPIFFS.open("/config.json", "r");
-            if (configFile)
+            Serial.println("opened config file");
+            const ConfigField fields[] = {
+                { "mqtt_server", mqtt_server, sizeof(mqtt_server) },
+                { "mqtt_port", mqtt_port, sizeof(mqtt_port) },
+                { "workgroup", workgroup, sizeof(workgroup) },
+                { "username", username, sizeof(username) },
+                { "password", password, sizeof(password) },
+                { "temp_scale", temp_scale, sizeof(temp_scale) },
+                { "timezone", timezone, sizeof(timezone) },
+                #ifdef HOME_ASSISTANT_DISCOVERY
+                { "ha_name", ha_name, sizeof(ha_name) },
+                #endif
+                #ifdef OTA_UPGRADES
+                { "ota_server", ota_server, sizeof(ota_server) },
+                #endif
+            };
+            if (parseConfig(configFile, fields, sizeof(fields) / sizeof(fields[0])))
             {
-                Serial.println("opened config file");
-                const size_t size = configFile.size();
-                std::unique_ptr<char[]> buf(new char[size]);
-                configFile.readBytes(buf.get(), size);
-                DynamicJsonDocument json(JSON_CONFIG_SIZE);
-                if (DeserializationError::Ok == deserializeJson(json, buf.get()))
-                {
-                    #ifdef DEBUG
-                    serializeJson(json, Serial);
-                    Serial.println("\nparsed json");
-                    #endif
-                    strcpy(mqtt_server, json["mqtt_server"]);
-                    strcpy(mqtt_port, json["mqtt_port"]);
-                    strcpy(workgroup, json["workgroup"]);
-                    strcpy(username, json["username"]);
-                    strcpy(password, json["password"]);
-                    strcpy(temp_scale, json["temp_scale"]);
-                    // Load timezone
-                    const char *tz = json["timezone"];
-                    if (tz) {
-                        strncpy(timezone, tz, sizeof(timezone) - 1);
-                        timezone[sizeof(timezone) - 1] = '\0';
-                    }
-                    #ifdef HOME_ASSISTANT_DISCOVERY
-                    const char *s = json["ha_name"];
-                    if (!s) s = machineId;
-                    snprintf(ha_name, sizeof(ha_name), "%s", s);
-                    #endif
-                    #ifdef OTA_UPGRADES
-                    const char *s2 = json["ota_server"];
-                    if (!s2) s2 = "";
-                    snprintf(ota_server, sizeof(ota_server), "%s", s2);
-                    #endif
-                }
-                else
-                {
-                    Serial.println("failed to load json config");
-                }
+                #ifdef DEBUG
+                Serial.println("parsed json");
+                #endif
+            }
+            else
+            {
+                Serial.println("failed to load json config");
             }
         }
     }
-    else
+}
+void NetworkConnector::packConfig(ConfigRecord& record) const
+{
+    memset(&record, 0, sizeof(record));
+    snprintf(record.mqtt_server, sizeof(record.mqtt_server), "%s", mqtt_server);
+    snprintf(record.mqtt_port, sizeof(record.mqtt_port), "%s", mqtt_port);
+    snprintf(record.workgroup, sizeof(record.workgroup), "%s", workgroup);
+    snprintf(record.username, sizeof(record.username), "%s", username);
+    snprintf(record.password, sizeof(record.password), "%s", password);
+    record.temp_celsius = String(temp_scale).equalsIgnoreCase("celsius") ? 1 : 0;
+    snprintf(record.timezone, sizeof(record.timezone), "%s", timezone);
+    #ifdef HOME_ASSISTANT_DISCOVERY
+    snprintf(record.ha_name, sizeof(record.ha_name), "%s", ha_name);
+    #endif
+    #ifdef OTA_UPGRADES
+    snprintf(record.ota_server, sizeof(record.ota_server), "%s", ota_server);
+    #endif
+}
+void NetworkConnector::unpackConfig(const ConfigRecord& record)
+{
+    // The CRC passed, but never trust a missing terminator
+    snprintf(mqtt_server, sizeof(mqtt_server), "%.*s", (int)sizeof(record.mqtt_server), record.mqtt_server);
+    snprintf(mqtt_port, sizeof(mqtt_port), "%.*s", (int)sizeof(record.mqtt_port), record.mqtt_port);
+    snprintf(workgroup, sizeof(workgroup), "%.*s", (int)sizeof(record.workgroup), record.workgroup);
+    snprintf(username, sizeof(username), "%.*s", (int)sizeof(record.username), record.username);
+    snprintf(password, sizeof(password), "%.*s", (int)sizeof(record.password), record.password);
+    strcpy(temp_scale, record.temp_celsius ? "celsius" : "fahrenheit");
+    snprintf(timezone, sizeof(timezone), "%.*s", (int)sizeof(record.timezone), record.timezone);
+    #ifdef HOME_ASSISTANT_DISCOVERY
+    snprintf(ha_name, sizeof(ha_name), "%.*s", (int)sizeof(record.ha_name), record.ha_name);
+    if ('\0' == ha_name[0])
     {
-        Serial.println("failed to mount FS");
+        snprintf(ha_name, sizeof(ha_name), "%s", machineId);
     }
+    #endif
+    #ifdef OTA_UPGRADES
+    snprintf(ota_server, sizeof(ota_server), "%.*s", (int)sizeof(record.ota_server), record.ota_server);
+    #endif
 }
-void NetworkConnector::saveConfig()
+void NetworkConnector::buildConfigJson(JsonDocument& json) const
 {
-    Serial.println("saving config");
-    DynamicJsonDocument json(JSON_CONFIG_SIZE);
     json["mqtt_server"] = mqtt_server;
     json["mqtt_port"] = mqtt_port;
     json["workgroup"] = workgroup;
@@ -623,15 +1407,23 @@ void NetworkConnector::saveConfig()
     #ifdef OTA_UPGRADES
     json["ota_server"] = ota_server;
     #endif
-    File configFile = SPIFFS.open("/config.json", "w");
-    if (!configFile)
+}
+void NetworkConnector::saveConfig()
+{
+    ConfigRecord record;
+    packConfig(record);
+    if (configStore.save(record))
     {
-        Serial.println("failed to open config file for writing");
+        // Keep the human readable copy in step for debugging, and as the
+        // migration source should the record layout change
+        DynamicJsonDocument json(JSON_CONFIG_SIZE);
+        buildConfigJson(json);
+        configStore.exportJson(json);
     }
-    serializeJson(json, Serial);
-    Serial.println("");
-    serializeJson(json, configFile);
-    configFile.close();
+}
+void NetworkConnector::requestSaveConfig()
+{
+    configStore.requestSave(millis());
 }
 #ifdef HOME_ASSISTANT_DISCOVERY
 void NetworkConnector::publishDiscoveryState()
@@ -640,8 +1432,9 @@ void NetworkConnector::publishDiscoveryState()
 }
 #endif
 #ifdef OTA_UPGRADES
-void NetworkConnector::do_ota_upgrade(const char* text)
+void NetworkConnector::do_ota_upgrade(const byte* payload, unsigned int length)
 {
+    Serial.println("OTA request seen.");
     // TODO: Implement OTA upgrade
 }
 #endif
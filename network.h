@@ -6,33 +6,137 @@
 #define NETWORK_FUNCTIONS_H
 #include <PubSubClient.h>
 #include <WiFiManager.h>
-#include <WiFiUdp.h>
-#include <NTPClient.h>
 #include <Arduino.h>
+#include <memory>
+#include "config.h"
+#include "config_store.h"
+#include "sntp.h"
+#include "rtc_clock.h"
+#include "time_zone.h"
+#include "display_link.h"
+#include "tcp_connector.h"
 class NetworkConnector {
 public:
     // Constructor
     NetworkConnector();
+    ~NetworkConnector();
     // Public methods used in setup()
     void begin();
     void setupWiFi();
     void setupMQTT();
     void printConfiguration();
     // Public methods used in loop()
+    void loop();
     void updateTime();
+    // Local time from the best source available: SNTP, the RTC, or the
+    // time cached before a reset; 0 when none is known yet
+    bool hasTime() const { return TIME_SOURCE_NONE != timeSource; }
     unsigned long getEpochTime();
+    enum TimeSource : uint8_t {
+        TIME_SOURCE_NONE,
+        TIME_SOURCE_CACHE,  // kept across a reset, error unknown
+        TIME_SOURCE_RTC,
+        TIME_SOURCE_SNTP
+    };
+    TimeSource getTimeSource() const { return timeSource; }
+    // Error bound of the active source, UINT32_MAX when unknown
+    uint32_t getTimeErrorMs() const;
+    bool isWiFiConnected() const { return wifiLinkState == WIFI_LINK_ONLINE; }
+    // Call with the debounced button state while the factory reset window
+    // after power on is open
+    void serviceFactoryReset(bool buttonPressed);
+    #ifdef PERF_PROBES
+    void publishPerf();
+    #endif
     // Getters for configuration
     bool isTempCelsius() const { return configTempCelsius; }
     const char* getMachineId() const { return machineId; }
-    long getTimezoneOffset() const { return timezoneOffset; }
+    bool isMqttConnected() const { return mqttLinkState == MQTT_LINK_ONLINE; }
+    // Offset east of UTC in force now, daylight saving time included
+    long getTimezoneOffset() { return timeZone.offsetAt(lastUtc); }
+    // Config flash writes done and skipped as unchanged
+    uint32_t getConfigWrites() const { return configStore.getWrites(); }
+    uint32_t getConfigWritesSkipped() const { return configStore.getSkipped(); }
+    // SNTP offset, delay, drift and poll state
+    const SntpClock& getSntp() const { return sntp; }
+    #ifdef RTC_HOLDOVER
+    const RtcClock& getRtc() const { return rtc; }
+    #endif
+    // Light state requested over MQTT, a color of 0 keeps the rainbow
+    bool isLightOn() const { return lightOn; }
+    uint32_t getLightColor() const { return lightColor; }
+    // Renderer side of the display link: commands from the network side,
+    // and what is shown, which goes out with the state document
+    bool nextDisplayCommand(DisplayCommand& command) { return displayCommands.pop(command); }
+    bool postDisplayReport(const DisplayReport& report) { return displayReports.push(report); }
+    // Network side only, the command queue has a single producer
+    bool postDisplayCommand(DisplayCommand::Type type, uint32_t value);
+    uint32_t getDisplayCommandsDropped() const { return displayCommands.getDropped(); }
 private:
-    // WiFi and NTP
-    WiFiUDP ntpUDP;
-    NTPClient timeClient;
-    long timezoneOffset;  // Timezone offset in seconds
+    // WiFi and time sources
+    SntpClock sntp;
+    #ifdef RTC_HOLDOVER
+    RtcClock rtc;
+    #endif
+    TimeSource timeSource;
+    uint32_t lastUtc;  // last UTC second handed out, time never steps back
+    TimeZone timeZone;
+    enum WifiLinkState {
+        WIFI_LINK_OFF,         // setupWiFi() not called yet
+        WIFI_LINK_CONNECTING,  // trying the stored credentials
+        WIFI_LINK_PORTAL,      // configuration portal open
+        WIFI_LINK_ONLINE
+    };
+    WiFiManager wifiManager;
+    WifiLinkState wifiLinkState;
+    unsigned long wifiDeadline;
+    bool factoryResetWindow;
+    unsigned long bootEpoch;  // UTC
+    unsigned long bootEpochAt;
+    unsigned long firstFrameMs;
     // MQTT
+    enum MqttLinkState {
+        MQTT_LINK_OFF,         // setupMQTT() not called yet
+        MQTT_LINK_BACKOFF,     // waiting for the next connection attempt
+        MQTT_LINK_CONNECTING,  // DNS lookup and TCP handshake under way
+        MQTT_LINK_ONLINE
+    };
+    TcpConnector mqttTransport;
     WiFiClient espClient;
     PubSubClient mqttClient;
+    MqttLinkState mqttLinkState;
+    unsigned long mqttRetryAt;
+    uint8_t mqttFailures;
+    // State document fields changed since the last publish
+    enum StateField : uint8_t {
+        STATE_POWER = 1 << 0,
+        STATE_COLOR = 1 << 1,
+        STATE_BRIGHTNESS = 1 << 2,
+        STATE_TEMP_SCALE = 1 << 3,
+        STATE_WORD_MASK = 1 << 4,
+        STATE_UPTIME = 1 << 5,
+        STATE_BOOT = 1 << 6,
+        STATE_TIME = 1 << 7,
+        STATE_ALL = 0xFF
+    };
+    uint8_t stateDirty;
+    unsigned long stateDueAt;
+    unsigned long statePublishedAt;
+    unsigned long stateUptimeAt;
+    bool lightOn;
+    uint32_t lightColor;
+    uint8_t shownBrightness;
+    uint64_t shownWordMask[LED_MASK_WORDS];
+    uint8_t shownWords;
+    uint16_t ledAverageMa;
+    uint16_t ledPeakMa;
+    // Display link, and what the renderer was last sent
+    DisplayCommandQueue displayCommands;
+    DisplayReportQueue displayReports;
+    bool postedLightOn;
+    uint32_t postedLightColor;
+    uint32_t postedEpoch;
+    uint8_t postedLink;
     // Configuration variables
     char mqtt_server[40];
     char mqtt_port[6];
@@ -40,54 +144,103 @@ private:
     char username[20];
     char password[20];
     char temp_scale[40];
-    char timezone[10];  // Stores timezone offset as string (e.g., "+2" or "-5")
+    char timezone[48];  // POSIX TZ rule, or hours east of UTC such as "+2" or "5.5"
     bool configTempCelsius;
     char machineId[33];
     bool shouldSaveConfig;
+    ConfigStore configStore;
     #ifdef HOME_ASSISTANT_DISCOVERY
     char ha_name[33];
     #endif
     #ifdef OTA_UPGRADES
     char ota_server[40];
     #endif
-    // MQTT Topics
-    char line1_topic[44];
-    char line2_topic[44];
-    char line3_topic[44];
-    char cmnd_temp_coefficient_topic[47];
-    char cmnd_temp_format[49];
-    char stat_temp_coefficient_topic[47];
-    char cmnd_led1_power_topic[50];
-    char cmnd_led1_color_topic[50];
-    char cmnd_reset_hue_topic[50];
-    char stat_led1_power_topic[50];
-    char stat_led1_color_topic[50];
-    #ifdef OTA_UPGRADES
-    char cmnd_update_topic[50];
-    #endif
+    // MQTT topics are <root>/<machineId>/<suffix>; only the roots are
+    // stored and a topic is assembled in topicScratch when it is needed
+    enum TopicNamespace : uint8_t {
+        TOPIC_CMND,
+        TOPIC_STAT,
+        TOPIC_WORKGROUP
+    };
+    enum Topic : uint8_t {
+        TOPIC_POWER,
+        TOPIC_COLOR,
+        TOPIC_RESET_HUE,
+        TOPIC_LINE1,
+        TOPIC_LINE2,
+        TOPIC_LINE3,
+        TOPIC_TEMP_COEFFICIENT,
+        TOPIC_TEMP_FORMAT,
+        TOPIC_TIMEZONE,
+        TOPIC_UPDATE,
+        TOPIC_PERF,
+        TOPIC_STATE,
+        TOPIC_COUNT
+    };
+    static const Topic subscribedTopics[];
+    char topicScratch[TOPIC_BUFFER_SIZE];
+    const char* buildTopic(TopicNamespace ns, const char* suffix);
+    const char* buildTopic(TopicNamespace ns, Topic topic);
+    const char* matchTopic(const char* topic, TopicNamespace ns) const;
+    // Portal form fields, only allocated while the portal is open
+    struct PortalParameters;
+    std::unique_ptr<PortalParameters> portal;
+    // Private methods - WiFi
+    void serviceWiFi();
+    void connectWiFi();
+    void startPortal();
+    void finishPortal();
+    void onWiFiConnected();
     // Private methods - Factory reset
-    void waitForFactoryReset();
     void factoryReset();
+    // MQTT command dispatch: the shared cmnd/<machineId>/ prefix is
+    // compared once, the rest of the topic is hashed to a handler
+    typedef void (NetworkConnector::*CommandHandler)(const byte* payload, unsigned int length);
+    struct CommandRoute {
+        Topic topic;
+        uint32_t hash;
+        CommandHandler handler;
+    };
+    static const CommandRoute commandRoutes[];
+    const CommandRoute* commandSlots[COMMAND_SLOTS];
     // Private methods - MQTT
+    void buildCommandTable();
+    const CommandRoute* findCommand(const char* suffix) const;
     void mqttCallback(char* topic, byte* payload, unsigned int length);
     static void mqttCallbackWrapper(char* topic, byte* payload, unsigned int length);
-    void processMessageScale(const char* text);
-    void mqttReconnect();
+    void processMessageScale(const byte* payload, unsigned int length);
+    void processMessageTimezone(const byte* payload, unsigned int length);
+    void processMessagePower(const byte* payload, unsigned int length);
+    void processMessageColor(const byte* payload, unsigned int length);
+    bool mqttConnect();
+    void mqttSubscribe();
+    void mqttScheduleRetry();
+    void markStateDirty(uint8_t fields);
+    void serviceState();
     void publishState();
+    void serviceDisplay();
+    void applyDisplayReport(const DisplayReport& report);
     void publishSensorData(const char* subTopic, const char* key, const float value);
     void publishSensorData(const char* subTopic, const char* key, const String& value);
     // Private methods - Configuration
     void calculateMachineId();
     void loadConfig();
+    void migrateConfig();
+    void packConfig(ConfigRecord& record) const;
+    void unpackConfig(const ConfigRecord& record);
+    void buildConfigJson(JsonDocument& json) const;
     void saveConfig();
+    void requestSaveConfig();
     void saveConfigCallback();
     static void saveConfigCallbackWrapper();
     void apWiFiCallback(WiFiManager *myWiFiManager);
     static void apWiFiCallbackWrapper(WiFiManager *myWiFiManager);
     // Private methods - Timezone
-    void updateTimezoneOffset();
-    const char* buildTimezoneDropdown();
-    const char* buildTimezoneDetectJS();
+    void applyTimezone();
+    void selectTimeSource();
+    // Config portal routes, served while the portal is open
+    void addPortalRoutes();
+    void sendTimezoneOptions();
     // Private methods - Temperature conversion
     float convertCelsiusToFahrenheit(float temperature);
     float convertTemperature(float temperature);
@@ -96,7 +249,7 @@ private:
     void publishDiscoveryState();
     #endif
     #ifdef OTA_UPGRADES
-    void do_ota_upgrade(const char* text);
+    void do_ota_upgrade(const byte* payload, unsigned int length);
     #endif
     // Static pointer for callbacks
     static NetworkConnector* instance;
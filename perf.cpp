@@ -0,0 +1,142 @@
+/*
+  ANAVI Word Clock - Performance Probes Implementation
+  Cycle-counter probes feeding per-stage log2 latency histograms
+*/
+
+#include "perf.h"
+
+#ifdef PERF_PROBES
+
+#include <freertos/FreeRTOS.h>
+
+static PerfHistogram histograms[PERF_STAGE_COUNT];
+static PerfHistogram snapshot[PERF_STAGE_COUNT];
+static portMUX_TYPE histogramLock = portMUX_INITIALIZER_UNLOCKED;
+
+static const char* const stageNames[PERF_STAGE_COUNT] = {
+    "updateTime",
+    "adjustBrightness",
+    "displayTime",
+    "applyMask",
+    "show"
+};
+
+PerfHistogram::PerfHistogram()
+{
+    reset();
+}
+
+void PerfHistogram::record(uint32_t cycles)
+{
+    const uint8_t bucket = 31 - __builtin_clz(cycles | 1);
+    buckets[bucket]++;
+    count++;
+    if (cycles > maxCycles)
+    {
+        maxCycles = cycles;
+    }
+}
+
+void PerfHistogram::reset()
+{
+    memset(buckets, 0, sizeof(buckets));
+    count = 0;
+    maxCycles = 0;
+}
+
+uint32_t PerfHistogram::percentile(uint8_t percent) const
+{
+    if (0 == count)
+    {
+        return 0;
+    }
+    const uint32_t rank = (uint32_t)(((uint64_t)count * percent + 99) / 100);
+    uint32_t seen = 0;
+    for (uint8_t bucket = 0; bucket < PERF_BUCKETS; bucket++)
+    {
+        seen += buckets[bucket];
+        if (seen >= rank)
+        {
+            return (bucket == 31) ? maxCycles : min((uint32_t)((2UL << bucket) - 1), maxCycles);
+        }
+    }
+    return maxCycles;
+}
+
+PerfProbe::~PerfProbe()
+{
+    const uint32_t cycles = ESP.getCycleCount() - start;
+    portENTER_CRITICAL(&histogramLock);
+    histograms[stage].record(cycles);
+    portEXIT_CRITICAL(&histogramLock);
+}
+
+void perfSnapshot()
+{
+    portENTER_CRITICAL(&histogramLock);
+    for (uint8_t stage = 0; stage < PERF_STAGE_COUNT; stage++)
+    {
+        snapshot[stage] = histograms[stage];
+        histograms[stage].reset();
+    }
+    portEXIT_CRITICAL(&histogramLock);
+}
+
+const PerfHistogram& perfHistogram(PerfStage stage)
+{
+    return snapshot[stage];
+}
+
+const char* perfStageName(PerfStage stage)
+{
+    return stageNames[stage];
+}
+
+void perfDump(Print& out)
+{
+    out.println("Loop stage latency [cycles]:");
+    for (uint8_t stage = 0; stage < PERF_STAGE_COUNT; stage++)
+    {
+        const PerfHistogram& histogram = snapshot[stage];
+        out.printf("  %-16s n=%lu p50<=%lu p99<=%lu max=%lu\n",
+                   stageNames[stage],
+                   (unsigned long)histogram.getCount(),
+                   (unsigned long)histogram.percentile(50),
+                   (unsigned long)histogram.percentile(99),
+                   (unsigned long)histogram.getMax());
+        for (uint8_t bucket = 0; bucket < PERF_BUCKETS; bucket++)
+        {
+            if (histogram.getBucket(bucket))
+            {
+                out.printf("    [%lu, %lu) %lu\n",
+                           (unsigned long)(1UL << bucket),
+                           (unsigned long)(bucket == 31 ? 0xFFFFFFFFUL : (2UL << bucket)),
+                           (unsigned long)histogram.getBucket(bucket));
+            }
+        }
+    }
+}
+
+size_t perfSummary(char* buffer, size_t size)
+{
+    // {"stage":[count,p50,p99,max],...}
+    size_t len = snprintf(buffer, size, "{");
+    for (uint8_t stage = 0; stage < PERF_STAGE_COUNT && len < size; stage++)
+    {
+        const PerfHistogram& histogram = snapshot[stage];
+        len += snprintf(buffer + len, size - len, "%s\"%s\":[%lu,%lu,%lu,%lu]",
+                        stage ? "," : "",
+                        stageNames[stage],
+                        (unsigned long)histogram.getCount(),
+                        (unsigned long)histogram.percentile(50),
+                        (unsigned long)histogram.percentile(99),
+                        (unsigned long)histogram.getMax());
+    }
+    if (len < size)
+    {
+        len += snprintf(buffer + len, size - len, "}");
+    }
+    return min(len, size - 1);
+}
+
+#endif // PERF_PROBES
@@ -0,0 +1,83 @@
+/*
+  ANAVI Word Clock - Performance Probes Header
+  Cycle-counter probes feeding per-stage log2 latency histograms.
+  Define PERF_PROBES to build them in; otherwise every probe compiles to
+  nothing.
+*/
+
+#ifndef PERF_PROBES_H
+#define PERF_PROBES_H
+
+#include <Arduino.h>
+#include "config.h"
+
+#ifdef PERF_PROBES
+
+enum PerfStage {
+    PERF_UPDATE_TIME,
+    PERF_ADJUST_BRIGHTNESS,
+    PERF_DISPLAY_TIME,
+    PERF_APPLY_MASK,
+    PERF_SHOW,
+    PERF_STAGE_COUNT
+};
+
+#define PERF_BUCKETS 32
+
+// Bucket k counts samples of [2^k, 2^(k+1)) cycles
+class PerfHistogram {
+public:
+    PerfHistogram();
+
+    void record(uint32_t cycles);
+    void reset();
+
+    uint32_t getCount() const { return count; }
+    uint32_t getMax() const { return maxCycles; }
+    uint32_t getBucket(uint8_t bucket) const { return buckets[bucket]; }
+
+    // Upper bound of the bucket holding the given percentile
+    uint32_t percentile(uint8_t percent) const;
+
+private:
+    uint32_t buckets[PERF_BUCKETS];
+    uint32_t count;
+    uint32_t maxCycles;
+};
+
+class PerfProbe {
+public:
+    explicit PerfProbe(PerfStage stage) : stage(stage), start(ESP.getCycleCount()) {}
+    ~PerfProbe();
+
+private:
+    PerfStage stage;
+    uint32_t start;
+};
+
+// The probes record from the render task while the report runs in the
+// network task, so a report first moves the live histograms into a
+// snapshot and starts them over, all in one critical section. The
+// functions below read that snapshot.
+void perfSnapshot();
+
+const PerfHistogram& perfHistogram(PerfStage stage);
+const char* perfStageName(PerfStage stage);
+
+// Full histograms, one line per populated bucket
+void perfDump(Print& out);
+
+// Compact JSON summary for MQTT, returns the length written
+size_t perfSummary(char* buffer, size_t size);
+
+#define PERF_CONCAT_(a, b) a##b
+#define PERF_CONCAT(a, b) PERF_CONCAT_(a, b)
+#define PERF_PROBE(stage) PerfProbe PERF_CONCAT(perfProbe, __LINE__)(stage)
+
+#else
+
+#define PERF_PROBE(stage) do {} while (0)
+
+#endif // PERF_PROBES
+
+#endif // PERF_PROBES_H
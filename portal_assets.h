@@ -0,0 +1,67 @@
+/*
+  ANAVI Word Clock - Portal Assets
+  Generated by tools/embed_assets.py from assets/, do not edit
+*/
+
+#ifndef PORTAL_ASSETS_H
+#define PORTAL_ASSETS_H
+
+#include <Arduino.h>
+
+// assets/portal.js, 1792 bytes, 815 gzip'd
+#define PORTAL_JS_TYPE "application/javascript"
+const uint8_t PORTAL_JS_GZ[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x8d, 0x54, 0xdf, 0x6f, 0xdb, 0x36,
+    0x10, 0x7e, 0xf7, 0x5f, 0x71, 0xf1, 0x43, 0x2a, 0x2d, 0x8a, 0x9c, 0xbd, 0xf4, 0xc5, 0xf3, 0x43,
+    0x96, 0xb6, 0x98, 0x8b, 0x66, 0xc5, 0x50, 0xb7, 0xc5, 0x30, 0x0c, 0x03, 0x23, 0x9e, 0x2c, 0xb6,
+    0x14, 0xe9, 0x91, 0x27, 0x37, 0xce, 0x9a, 0xff, 0xbd, 0x77, 0xfa, 0x65, 0x2f, 0x31, 0x82, 0x08,
+    0xb0, 0x4c, 0x91, 0xdf, 0x1d, 0xbf, 0xef, 0xee, 0x23, 0x67, 0x33, 0xb8, 0xfc, 0xfd, 0xf2, 0xd3,
+    0x12, 0x3e, 0xfb, 0xa0, 0xe1, 0xca, 0xfa, 0xe2, 0x2b, 0x9c, 0x43, 0xe1, 0x5d, 0x69, 0xd6, 0x4d,
+    0x50, 0x64, 0xbc, 0x83, 0x8d, 0x0f, 0xa4, 0x2c, 0xc4, 0x22, 0x98, 0x0d, 0x4d, 0x66, 0x33, 0xf8,
+    0x80, 0x61, 0x8b, 0x1a, 0xd6, 0x77, 0x66, 0xf3, 0x42, 0x43, 0x19, 0x7c, 0x0d, 0xa5, 0x55, 0xb1,
+    0x02, 0x15, 0x61, 0xd6, 0xa1, 0xf3, 0x2f, 0x31, 0x83, 0x88, 0x08, 0xe4, 0xbd, 0x8d, 0x33, 0xac,
+    0x6f, 0x50, 0xff, 0xa3, 0x62, 0x44, 0x8a, 0xf9, 0x66, 0x37, 0xd1, 0xbe, 0x68, 0x6a, 0x74, 0x94,
+    0x2b, 0xad, 0x5f, 0x6f, 0x79, 0xf0, 0xce, 0x44, 0x42, 0x87, 0x21, 0x99, 0xbe, 0x7a, 0x7f, 0x7d,
+    0xe5, 0x1d, 0xc9, 0x9c, 0x57, 0x1a, 0xf5, 0x34, 0x83, 0xb2, 0x71, 0x45, 0xcb, 0x24, 0x49, 0xe1,
+    0xbf, 0x09, 0xc0, 0x56, 0x05, 0xa8, 0x55, 0x51, 0x19, 0x87, 0x4b, 0x0d, 0x0b, 0x18, 0xb3, 0xad,
+    0x91, 0x5e, 0x5b, 0x94, 0xe1, 0xaf, 0xbb, 0xa5, 0x4e, 0xa6, 0xb5, 0xd1, 0xd3, 0x74, 0xce, 0x11,
+    0xa6, 0x84, 0x64, 0x8c, 0xe8, 0x92, 0x00, 0x94, 0x48, 0x45, 0x95, 0x4c, 0x7b, 0xc6, 0x33, 0xc1,
+    0xe6, 0x54, 0xa1, 0x4b, 0xf6, 0xfb, 0x05, 0xc6, 0x42, 0x40, 0x6a, 0x82, 0x83, 0x90, 0x13, 0xde,
+    0x52, 0x92, 0xce, 0xe1, 0x3e, 0x6d, 0xe3, 0x01, 0x1e, 0xc2, 0x05, 0x20, 0x11, 0xe3, 0x56, 0x6d,
+    0x48, 0x2f, 0x87, 0x89, 0xca, 0x97, 0x84, 0x0b, 0xa5, 0xfb, 0x49, 0xaf, 0x84, 0xee, 0x3e, 0xa0,
+    0xc5, 0x82, 0x9e, 0x12, 0x42, 0x77, 0x9d, 0x8e, 0x0e, 0xff, 0xc6, 0xa0, 0x7d, 0x52, 0x37, 0x99,
+    0x1a, 0xef, 0xbc, 0xc3, 0xbd, 0xf8, 0x93, 0x71, 0x97, 0xef, 0xdf, 0xe1, 0xa4, 0x4f, 0x91, 0xf6,
+    0xd2, 0x04, 0x34, 0xac, 0x1f, 0xe9, 0x48, 0x51, 0x29, 0xb7, 0xc6, 0x87, 0x7d, 0x18, 0x78, 0xe4,
+    0x5b, 0x65, 0x1b, 0x14, 0x71, 0x43, 0x86, 0x76, 0xa2, 0x93, 0xc9, 0x89, 0xd9, 0x2f, 0xab, 0x0a,
+    0xc1, 0x6f, 0x24, 0x32, 0x82, 0x0a, 0x08, 0x91, 0x02, 0xaa, 0x9a, 0x1d, 0x74, 0xb3, 0x03, 0xae,
+    0x20, 0x14, 0x62, 0xbb, 0xac, 0x1d, 0x46, 0x25, 0xce, 0x12, 0xee, 0x6c, 0xc2, 0x1a, 0x23, 0x7b,
+    0x48, 0x72, 0xa2, 0x9e, 0x3c, 0xea, 0x97, 0xd4, 0xe4, 0xb9, 0xfd, 0x7a, 0x88, 0xab, 0xa8, 0xb6,
+    0x83, 0x0d, 0x46, 0xde, 0xc6, 0xb1, 0xdc, 0xdf, 0x56, 0xd7, 0xef, 0x58, 0x8c, 0x00, 0xe6, 0xed,
+    0x32, 0xf3, 0xbf, 0x84, 0xd0, 0x58, 0x96, 0xd0, 0x50, 0x34, 0x1a, 0x5b, 0x9e, 0x96, 0xab, 0xc3,
+    0x06, 0x6f, 0x8a, 0xd6, 0xf4, 0x42, 0x97, 0xad, 0x0d, 0x7e, 0x8b, 0x01, 0xae, 0xff, 0x58, 0xad,
+    0x32, 0x30, 0x11, 0xbe, 0xe2, 0x86, 0xc6, 0x1c, 0xca, 0xed, 0x88, 0x3d, 0xb1, 0x06, 0xb4, 0x11,
+    0xa1, 0xf4, 0xd6, 0xfa, 0x6f, 0xb1, 0x4d, 0x75, 0x13, 0x78, 0x84, 0xa1, 0x05, 0x4a, 0x7f, 0x8b,
+    0x26, 0x84, 0xde, 0x2e, 0x03, 0xb3, 0xbe, 0x78, 0x7f, 0x8d, 0x13, 0x43, 0x55, 0x96, 0x4e, 0xe3,
+    0xed, 0xdf, 0xdd, 0x26, 0xd2, 0xe6, 0x21, 0xf6, 0xf4, 0x74, 0x48, 0x23, 0xde, 0xb8, 0x24, 0x0a,
+    0xe6, 0xa6, 0x21, 0x4c, 0xa6, 0x5a, 0x91, 0x3a, 0x17, 0x35, 0xd3, 0x14, 0x4e, 0x16, 0x0b, 0x70,
+    0x8d, 0xb5, 0x7b, 0x1b, 0x0c, 0x64, 0x57, 0x7b, 0x5a, 0x2f, 0x58, 0x5d, 0x59, 0xca, 0xb9, 0x05,
+    0xe3, 0xe0, 0xad, 0x72, 0x8d, 0x0a, 0x3b, 0x56, 0xa3, 0xe1, 0x6d, 0x63, 0x77, 0x99, 0x4c, 0x46,
+    0xe4, 0xfb, 0x42, 0x47, 0x40, 0x15, 0xb9, 0x04, 0x25, 0x7c, 0x5c, 0x5d, 0xe5, 0x87, 0x99, 0x62,
+    0xad, 0xac, 0xe5, 0xc2, 0x48, 0x95, 0xb8, 0x2c, 0x91, 0x38, 0x5a, 0xf1, 0x6d, 0x23, 0x2e, 0xcd,
+    0xc0, 0x71, 0x37, 0x2b, 0xf0, 0x01, 0x22, 0xd7, 0xb7, 0x92, 0x78, 0x29, 0x0a, 0xfe, 0xdb, 0x28,
+    0xf2, 0x21, 0x1f, 0xab, 0xb2, 0x43, 0x7e, 0x31, 0x5f, 0xfc, 0x06, 0xaf, 0x14, 0x2b, 0x49, 0x45,
+    0xd8, 0x1b, 0x66, 0xff, 0x27, 0x2f, 0x24, 0xe9, 0x7c, 0x04, 0x7e, 0xe9, 0x29, 0x2e, 0xe0, 0x7c,
+    0x04, 0x4b, 0x70, 0x06, 0x17, 0x19, 0xfc, 0xdc, 0x86, 0xad, 0xfa, 0xe3, 0xf1, 0xbe, 0x15, 0xc6,
+    0x66, 0xfe, 0x09, 0x5e, 0x5e, 0x1c, 0x64, 0x60, 0x61, 0x47, 0xc2, 0x5f, 0x3e, 0x33, 0x3c, 0x92,
+    0x9c, 0xcd, 0x6b, 0x45, 0x55, 0x5e, 0x1b, 0x97, 0xf4, 0x7c, 0xb2, 0x36, 0xed, 0x01, 0x4f, 0x1d,
+    0x69, 0x84, 0xa9, 0xdb, 0xa3, 0xb0, 0x92, 0xab, 0x92, 0x08, 0xd6, 0x30, 0xf2, 0x62, 0xce, 0x7f,
+    0xbf, 0x3c, 0xf2, 0x44, 0x6e, 0xd1, 0xad, 0xa9, 0xe2, 0xc5, 0xb3, 0xb3, 0xc1, 0xd1, 0xdd, 0x06,
+    0x1d, 0xe0, 0x98, 0x8d, 0x4c, 0xef, 0x98, 0xce, 0x33, 0x1b, 0x15, 0x22, 0x2e, 0x1d, 0x25, 0xdd,
+    0xf2, 0x31, 0xc3, 0xb0, 0xa4, 0x69, 0xca, 0xf2, 0x2f, 0x52, 0x58, 0xb0, 0x69, 0x44, 0xe1, 0xe9,
+    0x69, 0x9f, 0x42, 0x9e, 0x67, 0xa4, 0x60, 0xb9, 0x87, 0x29, 0xf8, 0x73, 0xcf, 0xf6, 0xe0, 0x0c,
+    0xfe, 0xcf, 0xd8, 0xcc, 0xdd, 0xcc, 0x1f, 0x63, 0xb4, 0x89, 0x1b, 0xc5, 0x57, 0x41, 0x7b, 0x4d,
+    0x25, 0xd2, 0xa5, 0x6e, 0x34, 0x5c, 0x54, 0x69, 0xba, 0x0f, 0xda, 0x5f, 0x70, 0xf2, 0xdc, 0x4f,
+    0x86, 0xb7, 0x5c, 0x4e, 0xf2, 0xfb, 0x01, 0x48, 0xe7, 0x9f, 0x2c, 0x00, 0x07, 0x00, 0x00,
+};
+
+#endif // PORTAL_ASSETS_H
@@ -0,0 +1,138 @@
+/*
+  ANAVI Word Clock - RTC Clock Implementation
+  Battery-backed RTC holdover, read sparingly and set from SNTP
+*/
+
+#include "rtc_clock.h"
+#include <Wire.h>
+
+RtcClock::RtcClock()
+    : present(false)
+    , valid(false)
+    , phaseKnown(false)
+    , setDue(false)
+    , readEpoch(0)
+    , readAt(0)
+    , setAt(0)
+    , checkedAt(0)
+    , skewSeconds(0)
+    , reads(0)
+    , writes(0)
+{
+}
+
+bool RtcClock::begin()
+{
+    Wire.begin();
+    present = rtc.begin(&Wire);
+    if (!present)
+    {
+        Serial.println("RTC: not found");
+        return false;
+    }
+    // Lost power means the oscillator stopped, and the registers with it
+    valid = !rtc.lostPower();
+    setDue = !valid;
+    if (valid)
+    {
+        readEpoch = rtc.now().unixtime();
+        readAt = millis();
+        setAt = readAt;
+        checkedAt = readAt;
+        reads++;
+        Serial.print("RTC: holding ");
+        Serial.println(readEpoch);
+    }
+    else
+    {
+        Serial.println("RTC: lost power, waiting for SNTP");
+    }
+    return valid;
+}
+
+uint32_t RtcClock::now() const
+{
+    return readEpoch + (millis() - readAt) / 1000;
+}
+
+uint32_t RtcClock::getErrorMs() const
+{
+    if (!valid)
+    {
+        return UINT32_MAX;
+    }
+    const unsigned long since = millis() - setAt;
+    return (phaseKnown ? RTC_ALIGN_US / 1000 : 1000) +
+           (uint32_t)((uint64_t)since * RTC_DRIFT_PPM / 1000000);
+}
+
+void RtcClock::service(const SntpClock& sntp)
+{
+    if (!present)
+    {
+        return;
+    }
+    const bool sntpGood = sntp.isSynchronized() && sntp.getErrorUs() / 1000 < getErrorMs();
+    if (sntpGood && (setDue || millis() - setAt >= RTC_SET_INTERVAL_S * 1000UL) && write(sntp))
+    {
+        return;
+    }
+    if (valid && millis() - checkedAt >= RTC_READ_INTERVAL_MS)
+    {
+        // With the phase known, read mid-second, away from the tick
+        const unsigned long fraction = (millis() - readAt) % 1000;
+        if (!phaseKnown || (fraction >= 250 && fraction < 750))
+        {
+            read(sntp);
+        }
+    }
+}
+
+void RtcClock::read(const SntpClock& sntp)
+{
+    const uint32_t seconds = rtc.now().unixtime();
+    checkedAt = millis();
+    reads++;
+    if (seconds != now())
+    {
+        // The chip ticked at another moment than predicted, so its phase
+        // is known only to within the second now
+        readEpoch = seconds;
+        readAt = millis();
+        phaseKnown = false;
+    }
+    if (sntp.isSynchronized())
+    {
+        skewSeconds = (int32_t)(seconds - sntp.now());
+        // Set it again once a whole second apart, or to learn the phase
+        setDue = setDue || !phaseKnown || 0 != skewSeconds;
+    }
+}
+
+bool RtcClock::write(const SntpClock& sntp)
+{
+    // Written just after an SNTP second starts, the chip counts its
+    // seconds in step with UTC from here on
+    const uint64_t utcUs = sntp.nowUs();
+    const uint32_t fraction = (uint32_t)(utcUs % 1000000);
+    if (fraction >= RTC_ALIGN_US)
+    {
+        return false;
+    }
+    const uint32_t seconds = (uint32_t)(utcUs / 1000000);
+    rtc.adjust(DateTime(seconds));
+    writes++;
+    readEpoch = seconds;
+    readAt = millis() - fraction / 1000;
+    setAt = readAt;
+    checkedAt = millis();
+    skewSeconds = 0;
+    phaseKnown = true;
+    setDue = false;
+    if (!valid)
+    {
+        Serial.println("RTC: set from SNTP");
+    }
+    valid = true;
+    return true;
+}
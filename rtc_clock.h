@@ -0,0 +1,64 @@
+/*
+  ANAVI Word Clock - RTC Clock Header
+  Battery-backed RTC holdover, read sparingly and set from SNTP
+*/
+
+#ifndef RTC_CLOCK_H
+#define RTC_CLOCK_H
+
+#include <Arduino.h>
+#include <RTClib.h>
+#include "config.h"
+#include "sntp.h"
+
+class RtcClock {
+public:
+    // Constructor
+    RtcClock();
+
+    // Probe the chip and take the time it kept over the power cycle.
+    // Returns true when that time can be shown.
+    bool begin();
+
+    // Re-read the chip once every RTC_READ_INTERVAL_MS and set it from
+    // SNTP when it has drifted or is due, call on every loop pass
+    void service(const SntpClock& sntp);
+
+    bool isPresent() const { return present; }
+    bool isValid() const { return valid; }
+
+    // UTC seconds, interpolated with millis() between reads
+    uint32_t now() const;
+
+    // Bound on the error of now(): the phase uncertainty of the last
+    // read plus the crystal tolerance since the chip was last set
+    uint32_t getErrorMs() const;
+
+    // Difference to SNTP seen at the last read, in whole seconds
+    int32_t getSkewSeconds() const { return skewSeconds; }
+
+    // I2C transactions so far, reads and writes
+    uint32_t getReads() const { return reads; }
+    uint32_t getWrites() const { return writes; }
+
+private:
+    RTC_CHIP rtc;
+    bool present;
+    bool valid;
+    bool phaseKnown;          // second boundary known to RTC_ALIGN_US
+    bool setDue;
+
+    uint32_t readEpoch;       // seconds read from the chip
+    unsigned long readAt;     // millis() at the start of that second
+    unsigned long setAt;      // millis() when the chip was last written
+    unsigned long checkedAt;  // millis() of the last I2C transaction
+    int32_t skewSeconds;
+
+    uint32_t reads;
+    uint32_t writes;
+
+    void read(const SntpClock& sntp);
+    bool write(const SntpClock& sntp);
+};
+
+#endif // RTC_CLOCK_H
@@ -0,0 +1,68 @@
+/*
+  ANAVI Word Clock - Task Scheduler Implementation
+  Cooperative deadline-based scheduler that drives loop() without blocking
+*/
+
+#include "scheduler.h"
+
+TaskScheduler::TaskScheduler()
+    : taskCount(0)
+{
+}
+
+int8_t TaskScheduler::addTask(TaskCallback callback, uint32_t periodMs)
+{
+    if (taskCount >= SCHEDULER_MAX_TASKS)
+    {
+        return -1;
+    }
+    Task& task = tasks[taskCount];
+    task.callback = callback;
+    task.periodUs = periodMs * 1000UL;
+    task.nextRunUs = micros();
+    return taskCount++;
+}
+
+void TaskScheduler::run()
+{
+    for (uint8_t i = 0; i < taskCount; i++)
+    {
+        Task& task = tasks[i];
+        const uint32_t now = micros();
+        // Signed difference keeps the comparison correct across wraparound
+        if ((int32_t)(now - task.nextRunUs) < 0)
+        {
+            continue;
+        }
+        task.callback();
+        task.nextRunUs += task.periodUs;
+        if ((int32_t)(now - task.nextRunUs) >= 0)
+        {
+            // More than a period behind: skip the missed runs instead of
+            // bursting through them
+            task.nextRunUs = now + task.periodUs;
+        }
+    }
+}
+
+JitterStats::JitterStats()
+    : count(0)
+    , maxUs(0)
+    , totalUs(0)
+{
+}
+
+void JitterStats::recordInterval(uint32_t intervalUs, uint32_t periodUs)
+{
+    record(intervalUs > periodUs ? intervalUs - periodUs : periodUs - intervalUs);
+}
+
+void JitterStats::record(uint32_t us)
+{
+    count++;
+    totalUs += us;
+    if (us > maxUs)
+    {
+        maxUs = us;
+    }
+}
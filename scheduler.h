@@ -0,0 +1,59 @@
+/*
+  ANAVI Word Clock - Task Scheduler Header
+  Cooperative deadline-based scheduler that drives loop() without blocking
+*/
+
+#ifndef TASK_SCHEDULER_H
+#define TASK_SCHEDULER_H
+
+#include <Arduino.h>
+
+#define SCHEDULER_MAX_TASKS 8
+
+class TaskScheduler {
+public:
+    typedef void (*TaskCallback)();
+
+    // Constructor
+    TaskScheduler();
+
+    // Register a task that runs every periodMs milliseconds. A period of 0
+    // runs the task on every pass. Returns the task id or -1 when full.
+    int8_t addTask(TaskCallback callback, uint32_t periodMs);
+
+    // Run every task whose deadline has passed, then return
+    void run();
+
+private:
+    struct Task {
+        TaskCallback callback;
+        uint32_t periodUs;
+        uint32_t nextRunUs;
+    };
+
+    Task tasks[SCHEDULER_MAX_TASKS];
+    uint8_t taskCount;
+};
+
+// How far periodic work strays from its schedule, and how long a hop
+// between tasks takes
+class JitterStats {
+public:
+    JitterStats();
+
+    // Time between two runs of work due every periodUs
+    void recordInterval(uint32_t intervalUs, uint32_t periodUs);
+    // A delay that would ideally be zero
+    void record(uint32_t us);
+
+    uint32_t getCount() const { return count; }
+    uint32_t getMaxUs() const { return maxUs; }
+    uint32_t getAverageUs() const { return count ? (uint32_t)(totalUs / count) : 0; }
+
+private:
+    uint32_t count;
+    uint32_t maxUs;
+    uint64_t totalUs;
+};
+
+#endif // TASK_SCHEDULER_H
@@ -0,0 +1,431 @@
+/*
+  ANAVI Word Clock - SNTP Clock Implementation
+  Disciplined UTC clock fed by several SNTP servers
+*/
+
+#include "sntp.h"
+
+#define NTP_PACKET_SIZE 48
+#define NTP_PORT 123
+#define NTP_UNIX_DELTA 2208988800ULL  // 1900-01-01 to 1970-01-01 in seconds
+#define SNTP_HOST_MAX 64     // longest server name without the port
+#define SNTP_MAX_MISSES 3    // rounds without a reply before a new lookup
+#define SNTP_FREQ_GAIN 2     // share of the measured drift taken per sample
+
+namespace {
+
+void writeTimestamp(uint8_t* out, uint64_t unixUs)
+{
+    const uint32_t seconds = (uint32_t)(unixUs / 1000000 + NTP_UNIX_DELTA);
+    const uint32_t fraction = (uint32_t)(((unixUs % 1000000) << 32) / 1000000);
+    for (uint8_t i = 0; i < 4; i++)
+    {
+        out[i] = (uint8_t)(seconds >> (24 - 8 * i));
+        out[4 + i] = (uint8_t)(fraction >> (24 - 8 * i));
+    }
+}
+
+uint64_t readTimestamp(const uint8_t* in)
+{
+    uint32_t seconds = 0;
+    uint32_t fraction = 0;
+    for (uint8_t i = 0; i < 4; i++)
+    {
+        seconds = (seconds << 8) | in[i];
+        fraction = (fraction << 8) | in[4 + i];
+    }
+    // Era 1 starts in 2036, its seconds have the top bit clear again
+    const uint64_t ntpSeconds = (seconds & 0x80000000UL) ? seconds : seconds + 0x100000000ULL;
+    return (ntpSeconds - NTP_UNIX_DELTA) * 1000000 + (((uint64_t)fraction * 1000000) >> 32);
+}
+
+int64_t absolute(int64_t value)
+{
+    return value < 0 ? -value : value;
+}
+
+int32_t clamp32(int64_t value)
+{
+    return value > INT32_MAX ? INT32_MAX : (value < INT32_MIN ? INT32_MIN : (int32_t)value);
+}
+
+} // namespace
+
+SntpClock::SntpClock()
+    : serverCount(0)
+    , started(false)
+    , monoUs(0)
+    , lastMicros(micros())
+    , baseUs(0)
+    , anchorUs(0)
+    , freqPpb(0)
+    , slewRemainingUs(0)
+    , synchronized(false)
+    , pollExponent(6)
+    , minExponent(6)
+    , maxExponent(10)
+    , nextPollUs(0)
+    , roundActive(false)
+    , roundDeadlineUs(0)
+    , lastSampleUs(0)
+    , haveSample(false)
+    , bestOffsetUs(0)
+    , bestDelayUs(0)
+    , bestServer(0)
+    , lastOffsetUs(0)
+    , lastStepUs(0)
+    , lastDelayUs(0)
+    , lastServer(0)
+    , samples(0)
+{
+}
+
+void SntpClock::setServers(const char* const* names, uint8_t count)
+{
+    serverCount = 0;
+    for (uint8_t i = 0; i < count && serverCount < SNTP_MAX_SERVERS; i++)
+    {
+        Server& server = servers[serverCount];
+        const char* colon = strchr(names[i], ':');
+        const size_t length = colon ? (size_t)(colon - names[i]) : strlen(names[i]);
+        if (0 == length || length >= SNTP_HOST_MAX)
+        {
+            continue;
+        }
+        server.name = names[i];
+        server.nameLength = (uint8_t)length;
+        server.port = colon ? (uint16_t)atoi(colon + 1) : NTP_PORT;
+        server.address = IPAddress();
+        server.resolvedAt = 0;
+        server.misses = 0;
+        server.pending = false;
+        serverCount++;
+    }
+}
+
+void SntpClock::setPollRange(uint16_t minSeconds, uint16_t maxSeconds)
+{
+    minExponent = 0;
+    while (minExponent < 15 && (2U << minExponent) <= minSeconds)
+    {
+        minExponent++;
+    }
+    maxExponent = minExponent;
+    while (maxExponent < 15 && (2U << maxExponent) <= maxSeconds)
+    {
+        maxExponent++;
+    }
+    pollExponent = minExponent;
+}
+
+void SntpClock::begin()
+{
+    if (!started)
+    {
+        udp.begin(SNTP_LOCAL_PORT);
+        started = true;
+    }
+    // The first round waits for these lookups
+    for (uint8_t i = 0; i < serverCount; i++)
+    {
+        resolve(servers[i]);
+    }
+    roundActive = false;
+    nextPollUs = monotonicNow();
+}
+
+uint64_t SntpClock::monotonicNow() const
+{
+    // Unsigned difference stays correct across the micros() wrap
+    return monoUs + (unsigned long)(micros() - lastMicros);
+}
+
+uint64_t SntpClock::localAt(uint64_t mono, int64_t* slewApplied) const
+{
+    const int64_t elapsed = (int64_t)(mono - anchorUs);
+    // The slew runs at most SNTP_SLEW_PPM faster or slower than the clock
+    const int64_t slewLimit = elapsed * SNTP_SLEW_PPM / 1000000;
+    int64_t slew = slewRemainingUs;
+    if (slew > slewLimit)
+    {
+        slew = slewLimit;
+    }
+    else if (slew < -slewLimit)
+    {
+        slew = -slewLimit;
+    }
+    if (slewApplied)
+    {
+        *slewApplied = slew;
+    }
+    return baseUs + elapsed + elapsed * freqPpb / 1000000000 + slew;
+}
+
+void SntpClock::rebase(uint64_t mono)
+{
+    int64_t slew;
+    baseUs = localAt(mono, &slew);
+    slewRemainingUs -= slew;
+    anchorUs = mono;
+}
+
+uint64_t SntpClock::nowUs() const
+{
+    return localAt(monotonicNow());
+}
+
+uint32_t SntpClock::getErrorUs() const
+{
+    if (!synchronized)
+    {
+        return UINT32_MAX;
+    }
+    const uint64_t error = (uint64_t)lastDelayUs / 2 +
+                           (monotonicNow() - lastSampleUs) * SNTP_HOLDOVER_PPM / 1000000;
+    return error < UINT32_MAX ? (uint32_t)error : UINT32_MAX - 1;
+}
+
+void SntpClock::service()
+{
+    const unsigned long sampled = micros();
+    monoUs += (unsigned long)(sampled - lastMicros);
+    lastMicros = sampled;
+    const uint64_t mono = monoUs;
+
+    // Keep the frequency term small, an hour without a sample is plenty
+    if (mono - anchorUs >= 3600ULL * 1000000)
+    {
+        rebase(mono);
+    }
+    if (!started)
+    {
+        return;
+    }
+    if (roundActive)
+    {
+        receive();
+        bool waiting = false;
+        for (uint8_t i = 0; i < serverCount; i++)
+        {
+            waiting = waiting || servers[i].pending;
+        }
+        if (!waiting || (int64_t)(monotonicNow() - roundDeadlineUs) >= 0)
+        {
+            finishRound(monotonicNow());
+        }
+    }
+    else if ((int64_t)(mono - nextPollUs) >= 0 && WL_CONNECTED == WiFi.status() && !awaitingLookup())
+    {
+        startRound(mono);
+    }
+}
+
+bool SntpClock::resolve(Server& server)
+{
+    uint32_t found;
+    if (server.lookup.take(found))
+    {
+        server.address = IPAddress(found);
+        server.resolvedAt = millis();
+        server.misses = 0;
+    }
+    const bool cached = (uint32_t)server.address != 0;
+    if (!cached || millis() - server.resolvedAt >= SNTP_DNS_TTL_S * 1000UL)
+    {
+        // A stale answer beats none, the new one is taken next round
+        char host[SNTP_HOST_MAX];
+        memcpy(host, server.name, server.nameLength);
+        host[server.nameLength] = '\0';
+        server.lookup.start(host);
+    }
+    return cached;
+}
+
+// A server without any address is worth waiting for, lookups give up
+// within the lwIP DNS timeout
+bool SntpClock::awaitingLookup() const
+{
+    for (uint8_t i = 0; i < serverCount; i++)
+    {
+        if ((uint32_t)servers[i].address == 0 && servers[i].lookup.isPending())
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void SntpClock::startRound(uint64_t mono)
+{
+    haveSample = false;
+    roundActive = false;
+    // All servers are asked at once, the round lasts one timeout
+    for (uint8_t i = 0; i < serverCount; i++)
+    {
+        Server& server = servers[i];
+        if (!resolve(server))
+        {
+            continue;
+        }
+        uint8_t packet[NTP_PACKET_SIZE] = { 0 };
+        packet[0] = 0x23;  // LI 0, version 4, mode 3 (client)
+        server.requestLocalUs = localAt(monotonicNow());
+        writeTimestamp(packet + 40, server.requestLocalUs);
+        memcpy(server.requestStamp, packet + 40, sizeof(server.requestStamp));
+        if (udp.beginPacket(server.address, server.port) &&
+            NTP_PACKET_SIZE == udp.write(packet, NTP_PACKET_SIZE) &&
+            udp.endPacket())
+        {
+            server.pending = true;
+            roundActive = true;
+        }
+    }
+    roundDeadlineUs = monotonicNow() + (uint64_t)SNTP_TIMEOUT_MS * 1000;
+    if (!roundActive)
+    {
+        nextPollUs = mono + (uint64_t)SNTP_RETRY_S * 1000000;
+    }
+}
+
+void SntpClock::receive()
+{
+    while (udp.parsePacket() > 0)
+    {
+        // Stamp the arrival before anything else
+        const uint64_t arrivedUs = localAt(monotonicNow());
+        uint8_t packet[NTP_PACKET_SIZE];
+        const int length = udp.read(packet, sizeof(packet));
+        const IPAddress from = udp.remoteIP();
+        const uint16_t fromPort = udp.remotePort();
+        if (NTP_PACKET_SIZE != length)
+        {
+            continue;
+        }
+        for (uint8_t i = 0; i < serverCount; i++)
+        {
+            Server& server = servers[i];
+            if (!server.pending || !(from == server.address) || fromPort != server.port ||
+                0 != memcmp(packet + 24, server.requestStamp, sizeof(server.requestStamp)))
+            {
+                continue;
+            }
+            server.pending = false;
+            const uint8_t leap = packet[0] >> 6;
+            const uint8_t mode = packet[0] & 0x07;
+            const uint8_t stratum = packet[1];
+            // Kiss-o'-death and unsynchronized servers are not samples
+            if (4 != mode || 0 == stratum || stratum > 15 || 3 == leap)
+            {
+                break;
+            }
+            server.misses = 0;
+            const int64_t receivedUs = (int64_t)readTimestamp(packet + 32);
+            const int64_t transmittedUs = (int64_t)readTimestamp(packet + 40);
+            const int64_t sentUs = (int64_t)server.requestLocalUs;
+            const int64_t offset = ((receivedUs - sentUs) + (transmittedUs - (int64_t)arrivedUs)) / 2;
+            int64_t delay = ((int64_t)arrivedUs - sentUs) - (transmittedUs - receivedUs);
+            if (delay < 0)
+            {
+                delay = 0;
+            }
+            // The shortest round trip has the least room for asymmetry
+            if (!haveSample || delay < bestDelayUs)
+            {
+                haveSample = true;
+                bestOffsetUs = offset;
+                bestDelayUs = delay;
+                bestServer = i;
+            }
+            break;
+        }
+    }
+}
+
+void SntpClock::finishRound(uint64_t mono)
+{
+    roundActive = false;
+    for (uint8_t i = 0; i < serverCount; i++)
+    {
+        Server& server = servers[i];
+        if (server.pending)
+        {
+            server.pending = false;
+            // A server that keeps quiet may have moved, look it up again
+            if (++server.misses >= SNTP_MAX_MISSES)
+            {
+                server.resolvedAt = millis() - SNTP_DNS_TTL_S * 1000UL;
+                server.misses = 0;
+            }
+        }
+    }
+    if (!haveSample)
+    {
+        nextPollUs = mono + (uint64_t)SNTP_RETRY_S * 1000000;
+        return;
+    }
+    applySample(mono);
+    nextPollUs = mono + ((uint64_t)1000000 << pollExponent);
+}
+
+void SntpClock::applySample(uint64_t mono)
+{
+    rebase(mono);
+    samples++;
+    lastDelayUs = clamp32(bestDelayUs);
+    lastServer = bestServer;
+
+    if (!synchronized || absolute(bestOffsetUs) > (int64_t)SNTP_STEP_THRESHOLD_MS * 1000)
+    {
+        // First sample or a jump: step, the frequency estimate is kept
+        baseUs += bestOffsetUs;
+        lastStepUs = bestOffsetUs;
+        lastOffsetUs = 0;
+        slewRemainingUs = 0;
+        pollExponent = minExponent;
+        lastSampleUs = mono;
+        Serial.print("SNTP: clock stepped by ");
+        Serial.print((long long)(bestOffsetUs / 1000));
+        Serial.print(" ms via ");
+        Serial.println(servers[bestServer].name);
+        synchronized = true;
+        return;
+    }
+
+    // Whatever is left of the last correction is still in the offset, the
+    // rest built up since then through the oscillator drift
+    const int64_t residual = bestOffsetUs - slewRemainingUs;
+    const int64_t interval = (int64_t)(mono - lastSampleUs);
+    lastSampleUs = mono;
+    if (interval > 0)
+    {
+        int64_t freq = freqPpb + residual * 1000000000 / interval / SNTP_FREQ_GAIN;
+        const int64_t limit = (int64_t)SNTP_SLEW_PPM * 1000;
+        freq = freq > limit ? limit : (freq < -limit ? -limit : freq);
+        freqPpb = (int32_t)freq;
+    }
+    slewRemainingUs = bestOffsetUs;
+    lastOffsetUs = (int32_t)bestOffsetUs;  // below the step threshold
+
+    // A quiet oscillator earns a longer poll, a noisy one a shorter poll
+    if (absolute(residual) < SNTP_STABLE_US)
+    {
+        if (pollExponent < maxExponent)
+        {
+            pollExponent++;
+        }
+    }
+    else if (absolute(residual) > 4 * (int64_t)SNTP_STABLE_US && pollExponent > minExponent)
+    {
+        pollExponent--;
+    }
+    Serial.print("SNTP: offset ");
+    Serial.print((long)bestOffsetUs);
+    Serial.print(" us, delay ");
+    Serial.print((long)bestDelayUs);
+    Serial.print(" us, drift ");
+    Serial.print((long)freqPpb);
+    Serial.print(" ppb, poll ");
+    Serial.print(getPollInterval());
+    Serial.print(" s via ");
+    Serial.println(servers[bestServer].name);
+}
@@ -0,0 +1,119 @@
+/*
+  ANAVI Word Clock - SNTP Clock Header
+  Disciplined UTC clock fed by several SNTP servers
+*/
+
+#ifndef SNTP_CLOCK_H
+#define SNTP_CLOCK_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <WiFiUdp.h>
+#include "config.h"
+#include "dns_lookup.h"
+
+class SntpClock {
+public:
+    // Constructor
+    SntpClock();
+
+    // Servers as "name" or "name:port". The strings are not copied.
+    void setServers(const char* const* names, uint8_t count);
+
+    // Poll interval bounds in seconds, rounded down to powers of two
+    void setPollRange(uint16_t minSeconds, uint16_t maxSeconds);
+
+    // Open the socket and poll at once. Call when the network is up.
+    void begin();
+
+    // Drive polling and replies, never blocks. Server names are looked up
+    // in the background and the cached address serves until the answer
+    // arrives. Call on every loop pass, also while WiFi is down: it keeps
+    // the local clock running.
+    void service();
+
+    // UTC, interpolated from micros() between polls
+    bool isSynchronized() const { return synchronized; }
+    uint64_t nowUs() const;
+    uint32_t now() const { return (uint32_t)(nowUs() / 1000000); }
+
+    // Last accepted sample, the frequency correction and the poll state.
+    // The offset is what remained after the sample was applied, so 0
+    // after a step; the step itself is kept apart.
+    int32_t getOffsetUs() const { return lastOffsetUs; }
+    int64_t getLastStepUs() const { return lastStepUs; }
+    int32_t getDelayUs() const { return lastDelayUs; }
+    int32_t getDriftPpb() const { return freqPpb; }
+    uint16_t getPollInterval() const { return (uint16_t)1 << pollExponent; }
+    const char* getServerName() const { return servers[lastServer].name; }
+    uint32_t getSamples() const { return samples; }
+
+    // Bound on the error of nowUs(): half the round trip of the last
+    // sample plus SNTP_HOLDOVER_PPM for the time since. UINT32_MAX until
+    // synchronized.
+    uint32_t getErrorUs() const;
+
+private:
+    struct Server {
+        const char* name;
+        uint8_t nameLength;      // without the ":port" suffix
+        uint16_t port;
+        IPAddress address;       // cached DNS answer
+        unsigned long resolvedAt;
+        DnsLookup lookup;        // refreshes address
+        uint8_t misses;          // rounds without a reply
+        bool pending;
+        uint64_t requestLocalUs; // our clock when the request left
+        uint8_t requestStamp[8]; // echoed back as the origin timestamp
+    };
+
+    WiFiUDP udp;
+    Server servers[SNTP_MAX_SERVERS];
+    uint8_t serverCount;
+    bool started;
+
+    // micros() extended to 64 bits
+    uint64_t monoUs;
+    unsigned long lastMicros;
+
+    // UTC = baseUs + elapsed * (1 + freqPpb / 1e9) + the part of
+    // slewRemainingUs worked off since anchorUs
+    uint64_t baseUs;
+    uint64_t anchorUs;
+    int32_t freqPpb;
+    int64_t slewRemainingUs;
+    bool synchronized;
+
+    // Polling
+    uint8_t pollExponent;
+    uint8_t minExponent;
+    uint8_t maxExponent;
+    uint64_t nextPollUs;
+    bool roundActive;
+    uint64_t roundDeadlineUs;
+    uint64_t lastSampleUs;
+
+    // Best sample of the running round, by round trip delay
+    bool haveSample;
+    int64_t bestOffsetUs;
+    int64_t bestDelayUs;
+    uint8_t bestServer;
+
+    int32_t lastOffsetUs;
+    int64_t lastStepUs;
+    int32_t lastDelayUs;
+    uint8_t lastServer;
+    uint32_t samples;
+
+    uint64_t monotonicNow() const;
+    uint64_t localAt(uint64_t mono, int64_t* slewApplied = nullptr) const;
+    void rebase(uint64_t mono);
+    void startRound(uint64_t mono);
+    void receive();
+    void finishRound(uint64_t mono);
+    void applySample(uint64_t mono);
+    bool resolve(Server& server);
+    bool awaitingLookup() const;
+};
+
+#endif // SNTP_CLOCK_H
@@ -0,0 +1,63 @@
+/*
+  ANAVI Word Clock - SPSC Ring Header
+  Lock-free queue between exactly one producer task and one consumer task
+*/
+
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <stdint.h>
+#include <atomic>
+
+// Each index is written by one side only, and the only atomics are
+// acquire loads and release stores. The ESP32-C3 core has no atomic
+// read-modify-write instructions, so no locking is needed and neither
+// side ever waits on the other. Neither side may block: a full ring
+// turns the item away and a drained one returns false.
+template <typename T, uint16_t SIZE>
+class SpscRing {
+public:
+    static_assert(SIZE > 0 && 0 == (SIZE & (SIZE - 1)), "SIZE must be a power of two");
+
+    SpscRing() : head(0), tail(0), dropped(0) {}
+
+    // Producer side
+    bool push(const T& item)
+    {
+        const uint32_t h = head.load(std::memory_order_relaxed);
+        if (SIZE == h - tail.load(std::memory_order_acquire))
+        {
+            dropped++;
+            return false;
+        }
+        items[h & (SIZE - 1)] = item;
+        // Publishes the item before the new head
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side
+    bool pop(T& item)
+    {
+        const uint32_t t = tail.load(std::memory_order_relaxed);
+        if (t == head.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+        item = items[t & (SIZE - 1)];
+        // Hands the slot back only after it has been read
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Items turned away because the ring was full, producer side
+    uint32_t getDropped() const { return dropped; }
+
+private:
+    T items[SIZE];
+    std::atomic<uint32_t> head;  // next slot to fill, written by the producer
+    std::atomic<uint32_t> tail;  // next slot to drain, written by the consumer
+    uint32_t dropped;
+};
+
+#endif // SPSC_RING_H
@@ -0,0 +1,130 @@
+/*
+  ANAVI Word Clock - TCP Connector Implementation
+  Opens a TCP connection over several passes without ever blocking
+*/
+
+#include "tcp_connector.h"
+#include <lwip/sockets.h>
+
+TcpConnector::TcpConnector()
+    : port(0)
+    , timeoutMs(0)
+    , startedAt(0)
+    , status(TCP_IDLE)
+    , fd(-1)
+{
+}
+
+TcpConnector::~TcpConnector()
+{
+    cancel();
+}
+
+void TcpConnector::begin(const char* host, uint16_t remotePort, uint32_t timeout)
+{
+    cancel();
+    port = remotePort;
+    timeoutMs = timeout;
+    startedAt = millis();
+    status = TCP_RESOLVING;
+    // A lookup left over from an attempt that timed out is waited for
+    if (!lookup.start(host))
+    {
+        fail();
+    }
+}
+
+TcpConnector::Status TcpConnector::poll()
+{
+    if ((TCP_RESOLVING == status || TCP_CONNECTING == status) && millis() - startedAt >= timeoutMs)
+    {
+        return fail();
+    }
+    if (TCP_RESOLVING == status)
+    {
+        if (lookup.isPending())
+        {
+            return status;
+        }
+        uint32_t address;
+        if (!lookup.take(address))
+        {
+            return fail();
+        }
+        startConnect(address);
+    }
+    if (TCP_CONNECTING != status)
+    {
+        return status;
+    }
+    // Writable once the handshake is over, one way or the other
+    fd_set writable;
+    FD_ZERO(&writable);
+    FD_SET(fd, &writable);
+    struct timeval now = { 0, 0 };
+    const int ready = lwip_select(fd + 1, nullptr, &writable, nullptr, &now);
+    if (0 == ready)
+    {
+        return status;
+    }
+    int error = 0;
+    socklen_t length = sizeof(error);
+    if (ready < 0 || 0 != lwip_getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &length) || 0 != error)
+    {
+        return fail();
+    }
+    // WiFiClient expects a blocking socket
+    lwip_fcntl(fd, F_SETFL, lwip_fcntl(fd, F_GETFL, 0) & ~O_NONBLOCK);
+    status = TCP_CONNECTED;
+    return status;
+}
+
+void TcpConnector::startConnect(uint32_t address)
+{
+    fd = lwip_socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (fd < 0)
+    {
+        fail();
+        return;
+    }
+    lwip_fcntl(fd, F_SETFL, lwip_fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+    struct sockaddr_in remote = {};
+    remote.sin_family = AF_INET;
+    remote.sin_port = htons(port);
+    remote.sin_addr.s_addr = address;
+    if (0 != lwip_connect(fd, (struct sockaddr*)&remote, sizeof(remote)) && EINPROGRESS != errno)
+    {
+        fail();
+        return;
+    }
+    status = TCP_CONNECTING;
+}
+
+int TcpConnector::release()
+{
+    if (TCP_CONNECTED != status)
+    {
+        return -1;
+    }
+    const int connected = fd;
+    fd = -1;
+    status = TCP_IDLE;
+    return connected;
+}
+
+void TcpConnector::cancel()
+{
+    if (fd >= 0)
+    {
+        lwip_close(fd);
+        fd = -1;
+    }
+    status = TCP_IDLE;
+}
+
+TcpConnector::Status TcpConnector::fail()
+{
+    cancel();
+    status = TCP_FAILED;
+    return status;
+}
@@ -0,0 +1,53 @@
+/*
+  ANAVI Word Clock - TCP Connector Header
+  Opens a TCP connection over several passes without ever blocking
+*/
+
+#ifndef TCP_CONNECTOR_H
+#define TCP_CONNECTOR_H
+
+#include <Arduino.h>
+#include "dns_lookup.h"
+
+// WiFiClient::connect() waits for the DNS lookup and the TCP handshake.
+// Here the name is looked up in the background, and the socket connects
+// in non-blocking mode, polled with a zero select() timeout. The connected
+// socket is then handed to a WiFiClient.
+class TcpConnector {
+public:
+    enum Status : uint8_t {
+        TCP_IDLE,
+        TCP_RESOLVING,
+        TCP_CONNECTING,
+        TCP_CONNECTED,
+        TCP_FAILED
+    };
+
+    TcpConnector();
+    ~TcpConnector();
+
+    // Starts a new attempt, giving up after timeoutMs
+    void begin(const char* host, uint16_t port, uint32_t timeoutMs);
+
+    // Moves the attempt on as far as it gets without waiting
+    Status poll();
+
+    // Socket of a connected attempt, owned by the caller from here on
+    int release();
+
+    // Drops the attempt and closes its socket
+    void cancel();
+
+private:
+    DnsLookup lookup;
+    uint16_t port;
+    uint32_t timeoutMs;
+    unsigned long startedAt;
+    Status status;
+    int fd;
+
+    void startConnect(uint32_t address);
+    Status fail();
+};
+
+#endif // TCP_CONNECTOR_H
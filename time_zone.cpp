@@ -0,0 +1,395 @@
+/*
+  ANAVI Word Clock - Time Zone Implementation
+  POSIX TZ rules with the DST transitions of the year precomputed
+*/
+
+#include "time_zone.h"
+#include <stdarg.h>
+
+namespace {
+
+// Days since 1970-01-01 of a proleptic Gregorian date
+int64_t daysFromCivil(int year, unsigned month, unsigned day)
+{
+    year -= month <= 2;
+    const int64_t era = (year >= 0 ? year : year - 399) / 400;
+    const unsigned yearOfEra = (unsigned)(year - era * 400);
+    const unsigned dayOfYear = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    const unsigned dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + (int64_t)dayOfEra - 719468;
+}
+
+int yearFromDays(int64_t days)
+{
+    days += 719468;
+    const int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+    const unsigned dayOfEra = (unsigned)(days - era * 146097);
+    const unsigned yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    const unsigned dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    const unsigned month = (5 * dayOfYear + 2) / 153;
+    return (int)(yearOfEra + era * 400) + (month >= 10 ? 1 : 0);
+}
+
+bool isLeap(int year)
+{
+    return (0 == year % 4 && 0 != year % 100) || 0 == year % 400;
+}
+
+uint8_t daysInMonth(int year, uint8_t month)
+{
+    static const uint8_t days[] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+    return (2 == month && isLeap(year)) ? 29 : days[month - 1];
+}
+
+bool readNumber(const char*& p, long& value, long max)
+{
+    if (!isdigit((unsigned char)*p))
+    {
+        return false;
+    }
+    value = 0;
+    while (isdigit((unsigned char)*p))
+    {
+        value = value * 10 + (*p++ - '0');
+        if (value > max)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// [+|-]hh[:mm[:ss]] in seconds
+bool readClock(const char*& p, long& seconds, long maxHours)
+{
+    long sign = 1;
+    if ('+' == *p || '-' == *p)
+    {
+        sign = ('-' == *p++) ? -1 : 1;
+    }
+    long hours;
+    long minutes = 0;
+    long secs = 0;
+    if (!readNumber(p, hours, maxHours))
+    {
+        return false;
+    }
+    if (':' == *p)
+    {
+        p++;
+        if (!readNumber(p, minutes, 59))
+        {
+            return false;
+        }
+        if (':' == *p)
+        {
+            p++;
+            if (!readNumber(p, secs, 59))
+            {
+                return false;
+            }
+        }
+    }
+    seconds = sign * (hours * 3600 + minutes * 60 + secs);
+    return true;
+}
+
+// Zone abbreviation: three or more letters, or anything between < and >
+bool skipName(const char*& p)
+{
+    if ('<' == *p)
+    {
+        const char* close = strchr(p, '>');
+        if (!close || close - p < 4)
+        {
+            return false;
+        }
+        p = close + 1;
+        return true;
+    }
+    const char* begin = p;
+    while (isalpha((unsigned char)*p))
+    {
+        p++;
+    }
+    return p - begin >= 3;
+}
+
+void append(char* out, size_t size, size_t& len, const char* format, ...)
+{
+    if (len >= size)
+    {
+        return;
+    }
+    va_list args;
+    va_start(args, format);
+    len += vsnprintf(out + len, size - len, format, args);
+    va_end(args);
+}
+
+// [-]h[:mm[:ss]]
+void appendClock(char* out, size_t size, size_t& len, long seconds)
+{
+    const unsigned long magnitude = seconds < 0 ? -seconds : seconds;
+    append(out, size, len, "%s%lu", seconds < 0 ? "-" : "", magnitude / 3600);
+    if (magnitude % 3600)
+    {
+        append(out, size, len, ":%02lu", magnitude / 60 % 60);
+        if (magnitude % 60)
+        {
+            append(out, size, len, ":%02lu", magnitude % 60);
+        }
+    }
+}
+
+// Numeric zone name such as <+02> or <-0330> for an offset east of UTC
+void appendName(char* out, size_t size, size_t& len, long east)
+{
+    const unsigned long magnitude = east < 0 ? -east : east;
+    append(out, size, len, "<%c%02lu", east < 0 ? '-' : '+', magnitude / 3600);
+    if (magnitude % 3600)
+    {
+        append(out, size, len, "%02lu", magnitude / 60 % 60);
+    }
+    append(out, size, len, ">");
+}
+
+} // namespace
+
+TimeZone::TimeZone()
+    : stdOffset(0)
+    , dstOffset(0)
+    , dst(false)
+    , start()
+    , end()
+    , yearStartUtc(0)
+    , yearEndUtc(0)
+    , dstStartUtc(0)
+    , dstEndUtc(0)
+{
+}
+
+bool TimeZone::setRule(const char* spec, const char* dstPreset)
+{
+    TimeZone zone;
+    const char* p = spec;
+    if (isPlainOffset(spec))
+    {
+        // Hours east of UTC, the format the portal has always stored
+        char* tail;
+        const double hours = strtod(p, &tail);
+        if (tail == p || '\0' != *tail || hours < -14 || hours > 14)
+        {
+            return false;
+        }
+        zone.stdOffset = lround(hours * 3600);
+        zone.dstOffset = zone.stdOffset + 3600;
+        const Transition daily = { Transition::MONTH_WEEK, 0, 0, 0, 0, 0 };
+        zone.start = daily;
+        zone.end = daily;
+        if (dstPreset && 0 == strcmp(dstPreset, "US"))
+        {
+            // Second Sunday in March to first Sunday in November, 02:00 local
+            zone.dst = true;
+            zone.start.month = 3; zone.start.week = 2; zone.start.time = 2 * 3600;
+            zone.end.month = 11; zone.end.week = 1; zone.end.time = 2 * 3600;
+        }
+        else if (dstPreset && 0 == strcmp(dstPreset, "EU"))
+        {
+            // Last Sunday in March to last Sunday in October, 01:00 UTC
+            zone.dst = true;
+            zone.start.month = 3; zone.start.week = 5; zone.start.time = 3600 + zone.stdOffset;
+            zone.end.month = 10; zone.end.week = 5; zone.end.time = 3600 + zone.dstOffset;
+        }
+    }
+    else
+    {
+        // POSIX: std offset [dst [offset] [,start[/time],end[/time]]], the
+        // offsets counted west of UTC
+        long west;
+        if (!skipName(p) || !readClock(p, west, 24))
+        {
+            return false;
+        }
+        zone.stdOffset = -west;
+        if ('\0' != *p)
+        {
+            if (!skipName(p))
+            {
+                return false;
+            }
+            zone.dst = true;
+            zone.dstOffset = zone.stdOffset + 3600;
+            if ('\0' != *p && ',' != *p)
+            {
+                if (!readClock(p, west, 24))
+                {
+                    return false;
+                }
+                zone.dstOffset = -west;
+            }
+            // The US rules are the POSIX default
+            const char* rules = (',' == *p) ? p + 1 : "M3.2.0,M11.1.0";
+            Transition* transitions[] = { &zone.start, &zone.end };
+            for (uint8_t i = 0; i < 2; i++)
+            {
+                Transition& rule = *transitions[i];
+                long value;
+                rule.time = 2 * 3600;
+                if ('M' == *rules)
+                {
+                    long month, week, weekday;
+                    rules++;
+                    if (!readNumber(rules, month, 12) || month < 1 || '.' != *rules++ ||
+                        !readNumber(rules, week, 5) || week < 1 || '.' != *rules++ ||
+                        !readNumber(rules, weekday, 6))
+                    {
+                        return false;
+                    }
+                    rule.kind = Transition::MONTH_WEEK;
+                    rule.month = (uint8_t)month;
+                    rule.week = (uint8_t)week;
+                    rule.weekday = (uint8_t)weekday;
+                }
+                else if ('J' == *rules)
+                {
+                    rules++;
+                    if (!readNumber(rules, value, 365) || value < 1)
+                    {
+                        return false;
+                    }
+                    rule.kind = Transition::JULIAN;
+                    rule.day = (uint16_t)value;
+                }
+                else
+                {
+                    if (!readNumber(rules, value, 365))
+                    {
+                        return false;
+                    }
+                    rule.kind = Transition::ZERO_BASED;
+                    rule.day = (uint16_t)value;
+                }
+                if ('/' == *rules)
+                {
+                    rules++;
+                    if (!readClock(rules, rule.time, 167))
+                    {
+                        return false;
+                    }
+                }
+                if (0 == i && ',' != *rules++)
+                {
+                    return false;
+                }
+            }
+            if ('\0' != *rules)
+            {
+                return false;
+            }
+        }
+    }
+    *this = zone;
+    return true;
+}
+
+bool TimeZone::isPlainOffset(const char* spec)
+{
+    return '+' == *spec || '-' == *spec || '.' == *spec || isdigit((unsigned char)*spec);
+}
+
+bool TimeZone::format(char* out, size_t size) const
+{
+    size_t len = 0;
+    appendName(out, size, len, stdOffset);
+    appendClock(out, size, len, -stdOffset);
+    if (dst)
+    {
+        appendName(out, size, len, dstOffset);
+        if (dstOffset != stdOffset + 3600)
+        {
+            appendClock(out, size, len, -dstOffset);
+        }
+        const Transition* transitions[] = { &start, &end };
+        for (const Transition* rule : transitions)
+        {
+            switch (rule->kind)
+            {
+                case Transition::JULIAN:
+                    append(out, size, len, ",J%u", rule->day);
+                    break;
+                case Transition::ZERO_BASED:
+                    append(out, size, len, ",%u", rule->day);
+                    break;
+                default:
+                    append(out, size, len, ",M%u.%u.%u", rule->month, rule->week, rule->weekday);
+                    break;
+            }
+            if (2 * 3600 != rule->time)
+            {
+                append(out, size, len, "/");
+                appendClock(out, size, len, rule->time);
+            }
+        }
+    }
+    return size > 0 && len < size;
+}
+
+int64_t TimeZone::transitionUtc(int year, const Transition& rule, long offsetBefore) const
+{
+    const int64_t newYear = daysFromCivil(year, 1, 1);
+    int64_t day;
+    switch (rule.kind)
+    {
+        case Transition::JULIAN:
+            day = newYear + rule.day - 1 + ((isLeap(year) && rule.day >= 60) ? 1 : 0);
+            break;
+        case Transition::ZERO_BASED:
+            day = newYear + rule.day;
+            break;
+        default:
+        {
+            const int64_t first = daysFromCivil(year, rule.month, 1);
+            // 1970-01-01 was a Thursday
+            const uint8_t firstWeekday = (uint8_t)(((first % 7) + 11) % 7);
+            int monthDay = 1 + (rule.weekday + 7 - firstWeekday) % 7 + (rule.week - 1) * 7;
+            if (monthDay > daysInMonth(year, rule.month))
+            {
+                monthDay -= 7;
+            }
+            day = first + monthDay - 1;
+            break;
+        }
+    }
+    // The rule's time is on the wall clock in force before the change
+    return day * 86400 + rule.time - offsetBefore;
+}
+
+void TimeZone::prepare(uint32_t utc)
+{
+    const int year = yearFromDays(utc / 86400);
+    yearStartUtc = daysFromCivil(year, 1, 1) * 86400;
+    yearEndUtc = daysFromCivil(year + 1, 1, 1) * 86400;
+    if (dst)
+    {
+        dstStartUtc = (uint32_t)transitionUtc(year, start, stdOffset);
+        dstEndUtc = (uint32_t)transitionUtc(year, end, dstOffset);
+    }
+}
+
+long TimeZone::offsetAt(uint32_t utc)
+{
+    if (!dst)
+    {
+        return stdOffset;
+    }
+    if ((int64_t)utc < yearStartUtc || (int64_t)utc >= yearEndUtc)
+    {
+        prepare(utc);
+    }
+    // South of the equator the period wraps around the new year
+    const bool inDst = (dstStartUtc < dstEndUtc)
+        ? (utc >= dstStartUtc && utc < dstEndUtc)
+        : (utc >= dstStartUtc || utc < dstEndUtc);
+    return inDst ? dstOffset : stdOffset;
+}
@@ -0,0 +1,75 @@
+/*
+  ANAVI Word Clock - Time Zone Header
+  POSIX TZ rules with the DST transitions of the year precomputed
+*/
+
+#ifndef TIME_ZONE_H
+#define TIME_ZONE_H
+
+#include <Arduino.h>
+
+class TimeZone {
+public:
+    // Constructor, UTC until a rule is set
+    TimeZone();
+
+    // Take a POSIX TZ rule such as "CET-1CEST,M3.5.0,M10.5.0/3", or a
+    // plain offset in hours such as "+2" or "5.5" to which the "US" or
+    // "EU" preset in dstPreset adds daylight saving time (nullptr or ""
+    // for none). Returns false and keeps the current rule when spec does
+    // not parse.
+    bool setRule(const char* spec, const char* dstPreset = nullptr);
+
+    // True for the plain offset form of setRule(), which depends on the
+    // DST preset it is read with
+    static bool isPlainOffset(const char* spec);
+
+    // The rule as POSIX TZ text, with numeric zone names such as <+0530>.
+    // Returns false when it does not fit in size.
+    bool format(char* out, size_t size) const;
+
+    // Offset east of UTC in seconds at the given UTC time. The transitions
+    // are worked out once per year, after that this is a comparison.
+    long offsetAt(uint32_t utc);
+    uint32_t toLocal(uint32_t utc) { return utc + offsetAt(utc); }
+
+    bool hasDst() const { return dst; }
+    long getStdOffset() const { return stdOffset; }
+    long getDstOffset() const { return dstOffset; }
+
+    // Transitions of the year last prepared, 0 without daylight saving time
+    uint32_t getDstStart() const { return dstStartUtc; }
+    uint32_t getDstEnd() const { return dstEndUtc; }
+
+private:
+    // One end of the daylight saving period, as POSIX writes it
+    struct Transition {
+        enum Kind : uint8_t {
+            JULIAN,       // Jn, 1 to 365, February 29 never counted
+            ZERO_BASED,   // n, 0 to 365
+            MONTH_WEEK    // Mm.w.d
+        } kind;
+        uint16_t day;
+        uint8_t month;
+        uint8_t week;      // 1 to 5, 5 is the last
+        uint8_t weekday;   // 0 is Sunday
+        long time;         // seconds after local midnight, may be negative
+    };
+
+    long stdOffset;
+    long dstOffset;
+    bool dst;
+    Transition start;
+    Transition end;
+
+    // Cached year, in UTC
+    int64_t yearStartUtc;
+    int64_t yearEndUtc;
+    uint32_t dstStartUtc;
+    uint32_t dstEndUtc;
+
+    void prepare(uint32_t utc);
+    int64_t transitionUtc(int year, const Transition& rule, long offsetBefore) const;
+};
+
+#endif // TIME_ZONE_H
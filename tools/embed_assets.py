@@ -0,0 +1,53 @@
+#!/usr/bin/env python3
+"""ANAVI Word Clock - embed the portal assets as gzip'd flash arrays
+
+Compresses every file listed in ASSETS and writes portal_assets.h next to
+the sketch. Run it after editing anything in assets/:
+
+    python3 tools/embed_assets.py
+"""
+
+import gzip
+import os
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+# (source under assets/, array name, MIME type)
+ASSETS = [
+    ("portal.js", "PORTAL_JS", "application/javascript"),
+]
+
+
+def main():
+    lines = [
+        "/*",
+        "  ANAVI Word Clock - Portal Assets",
+        "  Generated by tools/embed_assets.py from assets/, do not edit",
+        "*/",
+        "",
+        "#ifndef PORTAL_ASSETS_H",
+        "#define PORTAL_ASSETS_H",
+        "",
+        "#include <Arduino.h>",
+        "",
+    ]
+    for source, name, mime in ASSETS:
+        with open(os.path.join(ROOT, "assets", source), "rb") as f:
+            raw = f.read()
+        # mtime 0 keeps the output stable from run to run
+        packed = gzip.compress(raw, compresslevel=9, mtime=0)
+        lines.append("// assets/%s, %d bytes, %d gzip'd" % (source, len(raw), len(packed)))
+        lines.append('#define %s_TYPE "%s"' % (name, mime))
+        lines.append("const uint8_t %s_GZ[] PROGMEM = {" % name)
+        for i in range(0, len(packed), 16):
+            chunk = ", ".join("0x%02x" % b for b in packed[i:i + 16])
+            lines.append("    %s," % chunk)
+        lines.append("};")
+        lines.append("")
+    lines.append("#endif // PORTAL_ASSETS_H")
+    with open(os.path.join(ROOT, "portal_assets.h"), "w") as f:
+        f.write("\n".join(lines) + "\n")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,124 @@
+/*
+  ANAVI Word Clock - Word Layout Header
+  Compile-time word masks from a faceplate's letter grid
+*/
+
+#ifndef WORD_LAYOUT_H
+#define WORD_LAYOUT_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "word_mask.h"
+
+// How the LED strip runs through the rows, starting at the top
+enum PanelWiring : uint8_t {
+    PANEL_SERPENTINE,   // even rows right to left, odd rows left to right
+    PANEL_PROGRESSIVE   // every row left to right
+};
+
+// Size of the LED matrix and the strip position of each cell
+template <uint8_t WIDTH, uint8_t HEIGHT, PanelWiring WIRING>
+struct PanelGeometry {
+    static constexpr uint8_t COLS = WIDTH;
+    static constexpr uint8_t ROWS = HEIGHT;
+    static constexpr uint16_t CELLS = (uint16_t)WIDTH * HEIGHT;
+    static constexpr bool SERPENTINE = PANEL_SERPENTINE == WIRING;
+
+    using Mask = WordMask<CELLS>;
+
+    static constexpr uint16_t pixel(uint8_t row, uint8_t col)
+    {
+        return (uint16_t)row * COLS +
+               (SERPENTINE && 0 == row % 2 ? COLS - 1 - col : col);
+    }
+};
+
+// One letter of the grid, counted from the top left corner
+struct GridCell {
+    uint8_t row;
+    uint8_t col;
+};
+
+// Never defined. Reached only when a word does not match the grid, which
+// turns the mistake into a compile error ("call to non-constexpr function")
+// pointing at the word.
+void wordLayoutLettersDoNotMatch();
+void wordLayoutCellOutsideGrid();
+
+// Letter grid of a faceplate, one string literal per row as printed on
+// the front. Masks are indexed by strip position, see PanelGeometry.
+template <class PANEL>
+class WordLayout {
+public:
+    static constexpr uint8_t ROWS = PANEL::ROWS;
+    static constexpr uint8_t COLS = PANEL::COLS;
+    using Mask = typename PANEL::Mask;
+
+    constexpr explicit WordLayout(const char* const (&letters)[ROWS])
+        : rows(letters)
+    {
+        for (uint8_t row = 0; row < ROWS; row++)
+        {
+            for (uint8_t col = 0; col < COLS; col++)
+            {
+                if ('\0' == rows[row][col])
+                {
+                    wordLayoutCellOutsideGrid();
+                }
+            }
+            if ('\0' != rows[row][COLS])
+            {
+                wordLayoutCellOutsideGrid();
+            }
+        }
+    }
+
+    // Letters of word read left to right from (row, col)
+    constexpr Mask span(const char* word, uint8_t row, uint8_t col) const
+    {
+        Mask mask;
+        for (uint8_t i = 0; '\0' != word[i]; i++)
+        {
+            mask |= cell(word[i], row, col + i);
+        }
+        return mask;
+    }
+
+    // Letters of word picked one by one, for words that are not in a line
+    template <size_t N>
+    constexpr Mask cells(const char* word, const GridCell (&letters)[N]) const
+    {
+        Mask mask;
+        for (size_t i = 0; i < N; i++)
+        {
+            if ('\0' == word[i])
+            {
+                wordLayoutLettersDoNotMatch();
+            }
+            mask |= cell(word[i], letters[i].row, letters[i].col);
+        }
+        if ('\0' != word[N])
+        {
+            wordLayoutLettersDoNotMatch();
+        }
+        return mask;
+    }
+
+private:
+    const char* const* rows;
+
+    constexpr Mask cell(char letter, uint8_t row, uint8_t col) const
+    {
+        if (row >= ROWS || col >= COLS)
+        {
+            wordLayoutCellOutsideGrid();
+        }
+        if (letter != rows[row][col])
+        {
+            wordLayoutLettersDoNotMatch();
+        }
+        return Mask::pixel(PANEL::pixel(row, col));
+    }
+};
+
+#endif // WORD_LAYOUT_H
@@ -0,0 +1,130 @@
+/*
+  ANAVI Word Clock - Word Mask Header
+  Fixed-size bit set with one bit per LED of the panel
+*/
+
+#ifndef WORD_MASK_H
+#define WORD_MASK_H
+
+#include <stdint.h>
+
+// Pixel i is bit 63 - (i % 64) of word i / 64, so an 8x8 panel keeps the
+// single uint64_t layout with pixel 0 in the top bit. Every operation
+// works a 64-bit word at a time; with one word it is plain integer code.
+template <uint16_t CELLS>
+class WordMask {
+public:
+    static constexpr uint8_t WORDS = (CELLS + 63) / 64;
+
+    constexpr WordMask() : words{} {}
+
+    static constexpr WordMask pixel(uint16_t i)
+    {
+        WordMask mask;
+        mask.words[i / 64] = 1ULL << (63 - i % 64);
+        return mask;
+    }
+
+    // Every pixel of the panel
+    static constexpr WordMask all()
+    {
+        WordMask mask;
+        for (uint8_t w = 0; w < WORDS; w++)
+        {
+            mask.words[w] = ~0ULL;
+        }
+        if (CELLS % 64)
+        {
+            mask.words[WORDS - 1] = ~0ULL << (64 - CELLS % 64);
+        }
+        return mask;
+    }
+
+    constexpr WordMask operator|(const WordMask& other) const
+    {
+        WordMask mask;
+        for (uint8_t w = 0; w < WORDS; w++)
+        {
+            mask.words[w] = words[w] | other.words[w];
+        }
+        return mask;
+    }
+
+    constexpr WordMask operator&(const WordMask& other) const
+    {
+        WordMask mask;
+        for (uint8_t w = 0; w < WORDS; w++)
+        {
+            mask.words[w] = words[w] & other.words[w];
+        }
+        return mask;
+    }
+
+    constexpr WordMask& operator|=(const WordMask& other)
+    {
+        for (uint8_t w = 0; w < WORDS; w++)
+        {
+            words[w] |= other.words[w];
+        }
+        return *this;
+    }
+
+    // Pixels lit here but not in other
+    constexpr WordMask without(const WordMask& other) const
+    {
+        WordMask mask;
+        for (uint8_t w = 0; w < WORDS; w++)
+        {
+            mask.words[w] = words[w] & ~other.words[w];
+        }
+        return mask;
+    }
+
+    constexpr bool operator==(const WordMask& other) const
+    {
+        for (uint8_t w = 0; w < WORDS; w++)
+        {
+            if (words[w] != other.words[w])
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    constexpr bool operator!=(const WordMask& other) const { return !(*this == other); }
+
+    constexpr bool any() const
+    {
+        for (uint8_t w = 0; w < WORDS; w++)
+        {
+            if (words[w])
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Calls visit(i) for every set pixel, skipping empty words
+    template <typename Visitor>
+    void forEach(Visitor visit) const
+    {
+        for (uint8_t w = 0; w < WORDS; w++)
+        {
+            uint64_t bits = words[w];
+            while (bits)
+            {
+                visit((uint16_t)(w * 64 + 63 - __builtin_ctzll(bits)));
+                bits &= bits - 1;
+            }
+        }
+    }
+
+    const uint64_t* data() const { return words; }
+
+private:
+    uint64_t words[WORDS];
+};
+
+#endif // WORD_MASK_H